@@ -0,0 +1,430 @@
+/***
+ * File: bcast_algos_mpi.cpp
+ * Description: Broadcast algorithms for large payloads, benchmark and auto-selector
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 7:05:44 pm
+ * Last Modified: Saturday, 17th October 2026, 7:05:47 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+// This grows bcast_mpi.cpp into a broadcast engine for large payloads. The
+// library's MPI_Bcast is compared with three algorithms written with
+// point-to-point calls:
+//   - binomial tree: log2(p) rounds, the whole message in each; best for small messages
+//   - pipelined chain: the message is cut into chunks that flow down the
+//     chain 0 -> 1 -> ... -> p-1, so all links are busy at once
+//   - scatter + allgather (van de Geijn): each PE gets 1/p of the message and
+//     a ring allgather completes it; every PE sends and receives about 2x the
+//     message once, whatever p is, which wins for large messages
+// A calibration run times all of them for every size, and the "auto"
+// algorithm then uses the fastest one for each size. Read bcast_mpi.cpp first.
+//
+// Usage: mpirun -n <PEs> ./bcast_algos_mpi.exe [--max=<bytes>] [--iters=<int>] [--chunk=<bytes>]
+//                                             [--save=<file>] [--load=<file>]
+// --save writes the calibration (the number of PEs, then size and algorithm
+// per line); --load reads one back and skips the calibration. A calibration
+// only holds for the number of PEs it was measured with, so --load refuses
+// a file saved with a different one.
+
+// 1. Include MPI header
+#include <mpi.h>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+enum Algo
+{
+    ALGO_LIBRARY,   // MPI_Bcast
+    ALGO_BINOMIAL,  // binomial tree
+    ALGO_CHAIN,     // pipelined chain
+    ALGO_SCATTER,   // scatter + ring allgather
+    NALGOS,
+    ALGO_AUTO = NALGOS // the fastest of the above for each size, from the calibration
+};
+const char *const ALGO_NAMES[NALGOS + 1] = {"library", "binomial", "chain", "scatter_allgather", "auto"};
+
+// Binomial tree. In ranks relative to the root, PE r receives from r minus
+// its lowest set bit, and then sends to r + 2^k for every 2^k below that bit.
+void bcast_binomial(char *buf, int count, int root, MPI_Comm comm)
+{
+    int rank, size, vr, mask;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    vr = (rank - root + size) % size;
+
+    mask = 1;
+    while (mask < size)
+    {
+        if (vr & mask)
+        {
+            MPI_Recv(buf, count, MPI_CHAR, (rank - mask + size) % size, 0, comm, MPI_STATUS_IGNORE);
+            break;
+        }
+        mask = mask << 1;
+    }
+    mask = mask >> 1;
+    while (mask > 0)
+    {
+        if (vr + mask < size)
+        {
+            MPI_Send(buf, count, MPI_CHAR, (rank + mask) % size, 0, comm);
+        }
+        mask = mask >> 1;
+    }
+}
+
+// Pipelined chain with chunks of chunk bytes. A PE forwards each chunk with
+// MPI_Isend as soon as it has it and goes on receiving the next one.
+void bcast_chain(char *buf, int count, int chunk, int root, MPI_Comm comm)
+{
+    int rank, size, vr, prev, next, first, len, nchunks, c;
+    vector<MPI_Request> req;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    vr = (rank - root + size) % size;
+    prev = (rank - 1 + size) % size;
+    next = (rank + 1) % size;
+
+    nchunks = (count + chunk - 1) / chunk;
+    req.reserve(nchunks);
+    for (c = 0; c < nchunks; c++)
+    {
+        first = c * chunk;
+        len = min(chunk, count - first);
+        if (vr > 0)
+        {
+            MPI_Recv(buf + first, len, MPI_CHAR, prev, 0, comm, MPI_STATUS_IGNORE);
+        }
+        if (vr < size - 1)
+        {
+            req.push_back(MPI_REQUEST_NULL);
+            MPI_Isend(buf + first, len, MPI_CHAR, next, 0, comm, &req.back());
+        }
+    }
+    MPI_Waitall(req.size(), req.data(), MPI_STATUSES_IGNORE);
+}
+
+// Scatter + allgather. Piece i (in ranks relative to the root) is bytes
+// displs[i] .. displs[i] + counts[i] - 1; the root scatters them and a ring
+// allgather passes every piece around in p - 1 steps.
+void bcast_scatter_allgather(char *buf, int count, int root, MPI_Comm comm)
+{
+    int rank, size, vr, i, step, sendpiece, recvpiece;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    vr = (rank - root + size) % size;
+    if (count < size)
+    {
+        bcast_binomial(buf, count, root, comm); // not even one byte per PE
+        return;
+    }
+    vector<int> counts(size), displs(size), sc(size), sd(size);
+    for (i = 0; i < size; i++)
+    {
+        counts[i] = count / size + ((i < count % size) ? 1 : 0);
+        displs[i] = (i == 0) ? 0 : displs[i - 1] + counts[i - 1];
+    }
+    // MPI_Scatterv indexes by rank, the pieces go by relative rank
+    for (i = 0; i < size; i++)
+    {
+        sc[i] = counts[(i - root + size) % size];
+        sd[i] = displs[(i - root + size) % size];
+    }
+    if (rank == root)
+    {
+        MPI_Scatterv(buf, sc.data(), sd.data(), MPI_CHAR, MPI_IN_PLACE, 0, MPI_CHAR, root, comm);
+    }
+    else
+    {
+        MPI_Scatterv(NULL, NULL, NULL, MPI_CHAR, buf + displs[vr], counts[vr], MPI_CHAR, root, comm);
+    }
+    for (step = 0; step < size - 1; step++)
+    {
+        sendpiece = (vr - step + size) % size;
+        recvpiece = (vr - step - 1 + size) % size;
+        MPI_Sendrecv(buf + displs[sendpiece], counts[sendpiece], MPI_CHAR, (rank + 1) % size, 0,
+                     buf + displs[recvpiece], counts[recvpiece], MPI_CHAR, (rank - 1 + size) % size, 0,
+                     comm, MPI_STATUS_IGNORE);
+    }
+}
+
+// The calibration: the fastest algorithm for messages of at least 'bytes'
+struct Choice
+{
+    long long bytes;
+    int algo;
+};
+
+// Broadcast with any of the algorithms; auto looks up the largest calibrated
+// size that does not exceed count
+void bcast(int algo, char *buf, int count, int chunk, int root, MPI_Comm comm, const vector<Choice> &table)
+{
+    size_t i;
+    if (algo == ALGO_AUTO)
+    {
+        algo = ALGO_LIBRARY;
+        for (i = 0; i < table.size() && table[i].bytes <= count; i++)
+        {
+            algo = table[i].algo;
+        }
+    }
+    switch (algo)
+    {
+    case ALGO_BINOMIAL:
+        bcast_binomial(buf, count, root, comm);
+        break;
+    case ALGO_CHAIN:
+        bcast_chain(buf, count, chunk, root, comm);
+        break;
+    case ALGO_SCATTER:
+        bcast_scatter_allgather(buf, count, root, comm);
+        break;
+    default:
+        MPI_Bcast(buf, count, MPI_CHAR, root, comm);
+        break;
+    }
+}
+
+// Median over iters broadcasts of the time taken by the slowest PE. Before
+// timing, one broadcast of a known pattern checks that the algorithm works.
+double time_bcast(int algo, vector<char> &buf, int count, int chunk, int iters, const vector<Choice> &table, bool &ok)
+{
+    int my_id, it, i, bad = 0, anybad;
+    double t, tmax;
+    vector<double> times;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_id);
+
+    for (i = 0; i < count; i++)
+    {
+        buf[i] = (my_id == 0) ? char(i * 7 + count) : 0;
+    }
+    bcast(algo, buf.data(), count, chunk, 0, MPI_COMM_WORLD, table);
+    for (i = 0; i < count; i++)
+    {
+        bad += (buf[i] != char(i * 7 + count)) ? 1 : 0;
+    }
+    MPI_Allreduce(&bad, &anybad, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ok = (anybad == 0);
+
+    for (it = 0; it < iters; it++)
+    {
+        MPI_Barrier(MPI_COMM_WORLD);
+        t = MPI_Wtime();
+        bcast(algo, buf.data(), count, chunk, 0, MPI_COMM_WORLD, table);
+        t = MPI_Wtime() - t;
+        MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        times.push_back(tmax);
+    }
+    sort(times.begin(), times.end());
+    return times[iters / 2];
+}
+
+int main(int argc, char *argv[])
+{
+    // 2. Declare variables
+    int my_id;                    // ID of each PE
+    int npes;                     // number of PEs
+    int mpierr;                   // MPI return codes
+    long long maxsize = 16 << 20; // largest payload, in bytes
+    int iters = 20;               // timed broadcasts per algorithm and size
+    int chunk = 128 << 10;        // chunk size of the pipelined chain
+    string save, load;            // calibration files
+    vector<long long> sizes;      // payload sizes to try
+    vector<Choice> table;         // fastest algorithm per size
+    vector<char> buf;             // the payload
+    long long size;
+    double t, best;
+    int i, a, besta;
+    int filepes;                  // number of PEs the loaded calibration was measured with
+    bool ok, allok = true;
+
+    // 3. Start the MPI environment
+    mpierr = MPI_Init(&argc, &argv);
+    mpierr = MPI_Comm_rank(MPI_COMM_WORLD, &my_id);
+    mpierr = MPI_Comm_size(MPI_COMM_WORLD, &npes);
+
+    // 4. Read options; everybody parses the same command line
+    for (i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg.compare(0, 6, "--max=") == 0)
+            maxsize = atoll(arg.c_str() + 6);
+        else if (arg.compare(0, 8, "--iters=") == 0)
+            iters = atoi(arg.c_str() + 8);
+        else if (arg.compare(0, 8, "--chunk=") == 0)
+            chunk = atoi(arg.c_str() + 8);
+        else if (arg.compare(0, 7, "--save=") == 0)
+            save = arg.substr(7);
+        else if (arg.compare(0, 7, "--load=") == 0)
+            load = arg.substr(7);
+        else
+            maxsize = -1;
+    }
+    if (maxsize < 1 || maxsize > (1LL << 30) || iters < 1 || chunk < 1)
+    {
+        if (my_id == 0)
+        {
+            cout << "Usage: mpirun -n <PEs> " << argv[0] << " [--max=<bytes, up to 1 GiB>] [--iters=<int>] [--chunk=<bytes>]";
+            cout << " [--save=<file>] [--load=<file>]" << endl;
+        }
+        mpierr = MPI_Finalize();
+        return 1;
+    }
+    for (size = 8; size < maxsize; size *= 4)
+    {
+        sizes.push_back(size);
+    }
+    sizes.push_back(maxsize);
+    buf.resize(maxsize);
+
+    // 5. Calibrate: time every algorithm for every size, or read an earlier calibration
+    if (!load.empty())
+    {
+        // PE 0 reads the table, everybody gets a copy
+        i = 0;
+        filepes = -1;
+        if (my_id == 0)
+        {
+            ifstream in(load.c_str());
+            Choice c;
+            string name;
+            if (!in)
+            {
+                filepes = -2;
+            }
+            else if (!(in >> name >> filepes) || name != "pes")
+            {
+                filepes = -1;
+            }
+            while (filepes == npes && in >> c.bytes >> name)
+            {
+                for (c.algo = 0; c.algo < NALGOS && name != ALGO_NAMES[c.algo]; c.algo++)
+                {
+                }
+                if (c.algo < NALGOS)
+                {
+                    table.push_back(c);
+                }
+            }
+            i = table.size();
+            if (filepes == -2)
+            {
+                cout << "Cannot open " << load << endl;
+            }
+            else if (filepes == -1)
+            {
+                cout << load << " does not start with the number of PEs; calibrate again with --save" << endl;
+            }
+            else if (filepes != npes)
+            {
+                cout << load << " was calibrated with " << filepes << " PEs, not " << npes << "; calibrate again with --save" << endl;
+            }
+        }
+        mpierr = MPI_Bcast(&filepes, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (filepes != npes)
+        {
+            mpierr = MPI_Finalize();
+            return 1;
+        }
+        mpierr = MPI_Bcast(&i, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        table.resize(i);
+        mpierr = MPI_Bcast(table.data(), i * sizeof(Choice), MPI_BYTE, 0, MPI_COMM_WORLD);
+        if (my_id == 0)
+        {
+            cout << "Loaded " << i << " calibration entries from " << load << endl;
+        }
+    }
+    else
+    {
+        if (my_id == 0)
+        {
+            cout << "Broadcast from PE 0 to " << npes << " PEs, median of " << iters << " broadcasts (slowest PE)" << endl;
+            cout << "algorithm,pes,bytes,time_us,MB_per_s" << endl;
+        }
+        for (i = 0; i < (int)sizes.size(); i++)
+        {
+            best = 0.0;
+            besta = ALGO_LIBRARY;
+            for (a = 0; a < NALGOS; a++)
+            {
+                t = time_bcast(a, buf, sizes[i], chunk, iters, table, ok);
+                allok = allok && ok;
+                if (a == 0 || t < best)
+                {
+                    best = t;
+                    besta = a;
+                }
+                if (my_id == 0)
+                {
+                    cout << ALGO_NAMES[a] << "," << npes << "," << sizes[i] << "," << fixed << setprecision(3);
+                    cout << 1.0e6 * t << "," << sizes[i] / t / 1.0e6 << defaultfloat << (ok ? "" : ",WRONG RESULT") << endl;
+                }
+            }
+            // consecutive sizes with the same winner share one entry
+            if (table.empty() || table.back().algo != besta)
+            {
+                Choice c = {sizes[i], besta};
+                table.push_back(c);
+            }
+        }
+        if (my_id == 0 && !save.empty())
+        {
+            ofstream out(save.c_str());
+            out << "pes " << npes << "\n";
+            for (i = 0; i < (int)table.size(); i++)
+            {
+                out << table[i].bytes << " " << ALGO_NAMES[table[i].algo] << "\n";
+            }
+            cout << "Calibration saved to " << save << endl;
+        }
+    }
+
+    // 6. The auto-selector with the calibration
+    if (my_id == 0)
+    {
+        cout << "Auto-selector:";
+        for (i = 0; i < (int)table.size(); i++)
+        {
+            cout << " " << ALGO_NAMES[table[i].algo] << " from " << table[i].bytes << " B" << (i + 1 < (int)table.size() ? "," : "");
+        }
+        cout << endl;
+    }
+    for (i = 0; i < (int)sizes.size(); i++)
+    {
+        t = time_bcast(ALGO_AUTO, buf, sizes[i], chunk, iters, table, ok);
+        allok = allok && ok;
+        if (my_id == 0)
+        {
+            cout << "auto," << npes << "," << sizes[i] << "," << fixed << setprecision(3);
+            cout << 1.0e6 * t << "," << sizes[i] / t / 1.0e6 << defaultfloat << (ok ? "" : ",WRONG RESULT") << endl;
+        }
+    }
+
+    // 7. Close MPI environment
+    mpierr = MPI_Finalize();
+
+    // goodbye
+    return allok ? 0 : 1;
+}
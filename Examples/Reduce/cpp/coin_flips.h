@@ -0,0 +1,210 @@
+/***
+ * File: coin_flips.h
+ * Description: Bit-packed coin flips: 64 flips per random word, biased coins by bit-sliced comparison
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 8:31:26 pm
+ * Last Modified: Saturday, 17th October 2026, 8:31:29 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef COIN_FLIPS_H
+#define COIN_FLIPS_H
+
+#include <mpi.h>
+#include <cstdint>
+#include <cmath>
+#include <random>
+
+// Two ways of flipping count coins that come out heads with probability p.
+// Both return the number of heads, and both call MPI_Test on *req every few
+// thousand flips so the library can progress a pending non-blocking reduction.
+
+// The straightforward way, as in reduce_mpi.cpp: one double from mt19937 per flip
+inline long long flip_uniform(long long count, double p, std::mt19937 &gen, std::uniform_real_distribution<> &urd,
+                              MPI_Request *req)
+{
+    long long i, heads = 0;
+    int done;
+    for (i = 0; i < count; i++)
+    {
+        if (urd(gen) < p)
+        {
+            heads = heads + 1;
+        }
+        if ((i & 4095) == 4095 && *req != MPI_REQUEST_NULL)
+        {
+            MPI_Test(req, &done, MPI_STATUS_IGNORE);
+        }
+    }
+    return heads;
+}
+
+// The fast way: every bit of a random 64-bit word is a fair flip, so
+// popcount(word) counts the heads of 64 flips at once.
+// The generator is xoshiro256++ (Blackman and Vigna), run as COIN_LANES
+// independent streams stored lane by lane. Each step is the same handful of
+// adds, shifts, rotates and xors on every lane, with no multiplications, so
+// the compiler turns the lane loops into vector instructions.
+const int COIN_LANES = 8;
+
+struct CoinRng
+{
+    uint64_t s[4][COIN_LANES];
+};
+
+inline uint64_t rotl64(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// SplitMix64 turns (seed, lane) into well-mixed starting states
+inline void coin_seed(CoinRng &rng, uint64_t seed)
+{
+    uint64_t z, x = seed * 0x9E3779B97F4A7C15ULL;
+    int i, l;
+    for (l = 0; l < COIN_LANES; l++)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            x += 0x9E3779B97F4A7C15ULL;
+            z = x;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            rng.s[i][l] = z ^ (z >> 31);
+        }
+    }
+}
+
+// One word from every lane
+inline void coin_next(CoinRng &rng, uint64_t out[COIN_LANES])
+{
+    uint64_t t;
+    int l;
+    for (l = 0; l < COIN_LANES; l++)
+    {
+        out[l] = rotl64(rng.s[0][l] + rng.s[3][l], 23) + rng.s[0][l];
+        t = rng.s[1][l] << 17;
+        rng.s[2][l] ^= rng.s[0][l];
+        rng.s[3][l] ^= rng.s[1][l];
+        rng.s[1][l] ^= rng.s[2][l];
+        rng.s[0][l] ^= rng.s[3][l];
+        rng.s[2][l] ^= t;
+        rng.s[3][l] = rotl64(rng.s[3][l], 45);
+    }
+}
+
+// With a biased coin, flip j is heads when a uniform number U_j < p. Write
+// U_j and p in binary, 0.u1u2u3... and 0.p1p2p3...: U_j < p is decided at
+// the first bit where they differ. Bit k of U for 64 flips at once is one
+// random word R_k, so with lt and eq as bit masks over the 64 flips
+//     p_k = 1:  lt |= eq & ~R_k;  eq &= R_k
+//     p_k = 0:                    eq &= ~R_k
+// and the loop stops as soon as eq is empty, after about 8 words on
+// average. p is used to COIN_PBITS bits; flips still tied after them are
+// tails, so the exact probability is floor(p * 2^COIN_PBITS) / 2^COIN_PBITS.
+const int COIN_PBITS = 53;
+
+// Heads among the flips of one word per lane, where lane l only counts the
+// flips in mask[l]
+inline long long coin_heads(CoinRng &rng, const uint64_t mask[COIN_LANES], uint64_t pbits)
+{
+    uint64_t r[COIN_LANES], lt[COIN_LANES], eq[COIN_LANES], any;
+    long long heads = 0;
+    int k, l;
+
+    for (l = 0; l < COIN_LANES; l++)
+    {
+        lt[l] = 0;
+        eq[l] = mask[l];
+    }
+    for (k = COIN_PBITS - 1; k >= 0; k--)
+    {
+        coin_next(rng, r);
+        any = 0;
+        if ((pbits >> k) & 1)
+        {
+            for (l = 0; l < COIN_LANES; l++)
+            {
+                lt[l] |= eq[l] & ~r[l];
+                eq[l] &= r[l];
+                any |= eq[l];
+            }
+        }
+        else
+        {
+            for (l = 0; l < COIN_LANES; l++)
+            {
+                eq[l] &= ~r[l];
+                any |= eq[l];
+            }
+        }
+        if (any == 0)
+        {
+            break;
+        }
+    }
+    for (l = 0; l < COIN_LANES; l++)
+    {
+        heads += __builtin_popcountll(lt[l]);
+    }
+    return heads;
+}
+
+// p as a COIN_PBITS-bit binary fraction; 0.5 is the fair coin
+inline uint64_t coin_pbits(double p)
+{
+    return (uint64_t)std::floor(p * std::ldexp(1.0, COIN_PBITS));
+}
+
+inline long long flip_bits(long long count, uint64_t pbits, CoinRng &rng, MPI_Request *req)
+{
+    const uint64_t half = 1ULL << (COIN_PBITS - 1);
+    uint64_t r[COIN_LANES], mask[COIN_LANES];
+    long long w, left, heads = 0;
+    int done, l;
+
+    for (w = 0; w < count; w += 64 * COIN_LANES)
+    {
+        // flips beyond count are masked out of the last words
+        for (l = 0; l < COIN_LANES; l++)
+        {
+            left = count - w - 64 * l;
+            mask[l] = (left >= 64) ? ~0ULL : (left > 0) ? (1ULL << left) - 1 : 0ULL;
+        }
+        if (pbits == half)
+        {
+            coin_next(rng, r);
+            for (l = 0; l < COIN_LANES; l++)
+            {
+                heads += __builtin_popcountll(r[l] & mask[l]);
+            }
+        }
+        else
+        {
+            heads += coin_heads(rng, mask, pbits);
+        }
+        if ((w & 262143) == 0 && *req != MPI_REQUEST_NULL)
+        {
+            MPI_Test(req, &done, MPI_STATUS_IGNORE);
+        }
+    }
+    return heads;
+}
+
+#endif
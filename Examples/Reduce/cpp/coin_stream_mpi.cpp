@@ -0,0 +1,210 @@
+/***
+ * File: coin_stream_mpi.cpp
+ * Description: Coin-toss experiment that runs until the estimate of P(heads) is accurate enough
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 7:48:02 pm
+ * Last Modified: Saturday, 17th October 2026, 7:48:05 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+// reduce_mpi.cpp flips a fixed number of coins. Here the PEs flip in
+// batches, and the job stops once the 95% confidence interval on P(heads)
+// is narrower than --width. The running totals are combined with a
+// non-blocking MPI_Iallreduce. It completes while the next batch is being
+// flipped, so checking for convergence costs almost nothing. Every PE gets
+// the same totals, so they all decide to stop at the same time. Read
+// reduce_mpi.cpp first.
+//
+// The flips themselves come from one of two engines (coin_flips.h):
+// --engine=bits (default) packs 64 flips into every random word, and
+// --engine=uniform draws one double per flip as reduce_mpi.cpp does. --p sets
+// the probability of heads. --bench=<flips per PE> only compares the speed
+// of the two engines.
+//
+// Usage: mpirun -n <PEs> ./coin_stream_mpi.exe [--width=<double>] [--batch=<flips per PE>] [--max=<total flips>]
+//                                             [--p=<double>] [--engine=bits|uniform] [--bench=<flips per PE>]
+
+// 1. Include MPI header
+#include <mpi.h>    // MPI
+#include <iostream> // input/output
+#include <random>   // random number generator
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include "coin_flips.h"
+
+using namespace std;
+
+// Flip count coins with either engine (see coin_flips.h)
+long long flip(bool bits, long long count, double prob, uint64_t pbits, CoinRng &rng,
+               mt19937 &gen, uniform_real_distribution<> &urd, MPI_Request *req)
+{
+    if (bits)
+    {
+        return flip_bits(count, pbits, rng, req);
+    }
+    return flip_uniform(count, prob, gen, urd, req);
+}
+
+int main(int argc, char *argv[])
+{
+    // 2. Declare variables
+    double width = 1.0e-3;                     // target width of the 95% confidence interval
+    long long batch = 1 << 20;                 // coin flips per PE between two checks
+    long long maxFlips = 1LL << 40;            // give up after this many flips in total
+    const double z = 1.959964;                 // 95% two-sided normal quantile
+    double prob = 0.5;                         // probability of heads
+    string engine = "bits";                    // bits | uniform
+    long long bench = 0;                       // flips per PE of the engine comparison (0: no comparison)
+    bool bits;
+    uint64_t pbits;                            // prob as a binary fraction, for the bits engine
+    CoinRng rng;                               // generator of the bits engine
+    long long heads[2], sum;
+    double tmax, rate[2];
+    int myID;                                  // ID of each PE
+    int nPEs;                                  // number of PEs
+    int mpierr;                                // MPI return codes
+    long long mine[2];                         // {heads, flips} of this PE so far
+    long long sent[2];                         // what this PE contributed to the reduction in flight
+    long long total[2];                        // {heads, flips} of everybody, as of the last reduction
+    MPI_Request req = MPI_REQUEST_NULL;        // the reduction in flight
+    double p, halfwidth;                       // estimate and half the confidence interval
+    int checks, i;
+    mt19937 gen;                               // Mersenne-Twister random number generator
+    uniform_real_distribution<> urd(0.0, 1.0); // uniform distribution over (0,1)
+    double t;
+
+    // 3. Start the MPI environment
+    mpierr = MPI_Init(&argc, &argv);
+    mpierr = MPI_Comm_rank(MPI_COMM_WORLD, &myID);
+    mpierr = MPI_Comm_size(MPI_COMM_WORLD, &nPEs);
+
+    // 4. Read options; everybody parses the same command line
+    for (i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg.compare(0, 8, "--width=") == 0)
+            width = atof(arg.c_str() + 8);
+        else if (arg.compare(0, 8, "--batch=") == 0)
+            batch = atoll(arg.c_str() + 8);
+        else if (arg.compare(0, 6, "--max=") == 0)
+            maxFlips = atoll(arg.c_str() + 6);
+        else if (arg.compare(0, 4, "--p=") == 0)
+            prob = atof(arg.c_str() + 4);
+        else if (arg.compare(0, 9, "--engine=") == 0)
+            engine = arg.substr(9);
+        else if (arg.compare(0, 8, "--bench=") == 0)
+            bench = atoll(arg.c_str() + 8);
+        else
+            width = -1.0;
+    }
+    if (width <= 0.0 || batch < 1 || maxFlips < 1 || prob <= 0.0 || prob >= 1.0 || bench < 0 ||
+        (engine != "bits" && engine != "uniform"))
+    {
+        if (myID == 0)
+        {
+            cout << "Usage: mpirun -n <PEs> " << argv[0] << " [--width=<double>] [--batch=<flips per PE>] [--max=<total flips>]";
+            cout << " [--p=<double>] [--engine=bits|uniform] [--bench=<flips per PE>]" << endl;
+        }
+        mpierr = MPI_Finalize();
+        return 1;
+    }
+
+    // start the random number generators with a different seed for each PE
+    gen.seed(myID * 100000);
+    coin_seed(rng, myID * 100000 + 1);
+    bits = (engine == "bits");
+    pbits = coin_pbits(prob);
+
+    // Engine comparison: the same number of flips per PE with each engine
+    if (bench > 0)
+    {
+        for (i = 0; i < 2; i++)
+        {
+            mpierr = MPI_Barrier(MPI_COMM_WORLD);
+            t = MPI_Wtime();
+            heads[i] = flip(i == 1, bench, prob, pbits, rng, gen, urd, &req);
+            t = MPI_Wtime() - t;
+            mpierr = MPI_Reduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+            mpierr = MPI_Reduce(&heads[i], &sum, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+            rate[i] = bench / tmax / 1.0e6;
+            if (myID == 0)
+            {
+                cout << (i == 1 ? "bits   " : "uniform") << ": " << rate[i] << " Mflips/s per PE (slowest PE), ";
+                cout << rate[i] * nPEs << " Mflips/s in total, P(heads) = " << double(sum) / (double(bench) * nPEs) << endl;
+            }
+        }
+        if (myID == 0)
+        {
+            cout << "The bits engine is " << rate[1] / rate[0] << "x faster for p = " << prob << endl;
+        }
+        mpierr = MPI_Finalize();
+        return 0;
+    }
+
+    // 5. Flip the first batch and start combining it
+    t = MPI_Wtime();
+    mine[0] = flip(bits, batch, prob, pbits, rng, gen, urd, &req);
+    mine[1] = batch;
+    sent[0] = mine[0];
+    sent[1] = mine[1];
+    mpierr = MPI_Iallreduce(sent, total, 2, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD, &req);
+
+    // 6. Keep flipping while the previous totals travel; stop when they are good enough
+    checks = 0;
+    while (true)
+    {
+        mine[0] += flip(bits, batch, prob, pbits, rng, gen, urd, &req);
+        mine[1] += batch;
+        mpierr = MPI_Wait(&req, MPI_STATUS_IGNORE);
+        checks++;
+
+        // normal approximation to the binomial: p +- z sqrt(p(1-p)/N)
+        p = double(total[0]) / total[1];
+        halfwidth = z * sqrt(p * (1.0 - p) / total[1]);
+        if (myID == 0 && (checks & (checks - 1)) == 0)
+        {
+            cout << "After " << total[1] << " flips: P(heads) = " << p << " +- " << halfwidth << endl;
+        }
+        if (2.0 * halfwidth <= width || total[1] >= maxFlips)
+        {
+            break;
+        }
+        sent[0] = mine[0];
+        sent[1] = mine[1];
+        mpierr = MPI_Iallreduce(sent, total, 2, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD, &req);
+    }
+
+    // 7. Everybody stops; one last reduction includes the batch flipped during the final check
+    mpierr = MPI_Reduce(mine, total, 2, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    t = MPI_Wtime() - t;
+    if (myID == 0)
+    {
+        p = double(total[0]) / total[1];
+        halfwidth = z * sqrt(p * (1.0 - p) / total[1]);
+        cout << "The total number of heads was " << total[0] << " out of " << total[1] << " flips" << endl;
+        cout << "P(heads) = " << p << " +- " << halfwidth << " (95% confidence; the coin has " << prob << "), " << checks << " checks, ";
+        cout << t << " s, " << total[1] / t / 1.0e6 << " Mflips/s" << endl;
+    }
+
+    // 8. Cleanup and close MPI
+    mpierr = MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,230 @@
+/***
+ * File: pingpong_mpi.cpp
+ * Description: Ping-pong latency and bandwidth benchmark for the point-to-point modes
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 6:20:13 pm
+ * Last Modified: Saturday, 17th October 2026, 6:20:16 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+// This grows snd_rcv_mpi.cpp into a benchmark: PE 0 and a peer PE bounce a
+// message back and forth for every size from 1 B to --max bytes, with each
+// of the point-to-point flavors below. Read snd_rcv_mpi.cpp first.
+//
+// Usage: mpirun -n 2 ./pingpong_mpi.exe [--max=<bytes>] [--iters=<int>] [--peer=<rank>]
+// Place PE 0 and the peer on the same node or on two nodes to compare
+// intra-node and inter-node costs.
+
+// 1. Include MPI header
+#include <mpi.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// The flavors we compare
+enum Mode
+{
+    MODE_SEND,       // MPI_Send / MPI_Recv
+    MODE_ISEND,      // MPI_Isend / MPI_Irecv with the reply's receive posted in advance
+    MODE_SENDRECV,   // both PEs exchange with MPI_Sendrecv at the same time
+    MODE_SSEND,      // MPI_Ssend / MPI_Recv: the send waits for the matching receive
+    MODE_PERSISTENT, // MPI_Send_init / MPI_Recv_init, restarted with MPI_Start
+    NMODES
+};
+const char *const MODE_NAMES[NMODES] = {"send", "isend", "sendrecv", "ssend", "persistent"};
+
+// One timed iteration of a ping-pong between me and other; returns its duration.
+// 'first' is true on PE 0, which sends first.
+double bounce(Mode mode, char *sbuf, char *rbuf, int size, int other, bool first, MPI_Request req[2])
+{
+    MPI_Request r[2];
+    double t = MPI_Wtime();
+
+    switch (mode)
+    {
+    case MODE_SEND:
+    case MODE_SSEND:
+        if (first)
+        {
+            if (mode == MODE_SSEND)
+                MPI_Ssend(sbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD);
+            else
+                MPI_Send(sbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD);
+            MPI_Recv(rbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+        else
+        {
+            MPI_Recv(rbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            if (mode == MODE_SSEND)
+                MPI_Ssend(sbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD);
+            else
+                MPI_Send(sbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD);
+        }
+        break;
+    case MODE_ISEND:
+        // the receive is posted before the send, so the reply never waits for it
+        MPI_Irecv(rbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD, &r[0]);
+        if (first)
+        {
+            MPI_Isend(sbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD, &r[1]);
+            MPI_Waitall(2, r, MPI_STATUSES_IGNORE);
+        }
+        else
+        {
+            MPI_Wait(&r[0], MPI_STATUS_IGNORE);
+            MPI_Isend(sbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD, &r[1]);
+            MPI_Wait(&r[1], MPI_STATUS_IGNORE);
+        }
+        break;
+    case MODE_SENDRECV:
+        // a single exchange in both directions at once
+        MPI_Sendrecv(sbuf, size, MPI_CHAR, other, 0, rbuf, size, MPI_CHAR, other, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        break;
+    case MODE_PERSISTENT:
+        // req[0] receives, req[1] sends; both were set up once for this size
+        if (first)
+        {
+            MPI_Start(&req[0]);
+            MPI_Start(&req[1]);
+            MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+        }
+        else
+        {
+            MPI_Start(&req[0]);
+            MPI_Wait(&req[0], MPI_STATUS_IGNORE);
+            MPI_Start(&req[1]);
+            MPI_Wait(&req[1], MPI_STATUS_IGNORE);
+        }
+        break;
+    default:
+        break;
+    }
+    return MPI_Wtime() - t;
+}
+
+int main(int argc, char *argv[])
+{
+    // 2. Declare variables
+    int my_id;                    // id of each PE
+    int npes;                     // number of PEs
+    int mpierr;                   // MPI return codes
+    long long maxsize = 64 << 20; // largest message, in bytes
+    long long size;               // current message size
+    int iters = 1000;             // timed iterations for messages up to 64 KiB (fewer above)
+    int peer = 1;                 // the PE that answers PE 0
+    int other;                    // who I talk to
+    int it, nit, nwarm, m;
+    vector<char> sbuf, rbuf;      // message buffers
+    vector<double> t;             // time of each iteration
+    MPI_Request req[2];
+    double scale, p50;
+
+    // 3. Start MPI environment
+    mpierr = MPI_Init(&argc, &argv);
+    mpierr = MPI_Comm_rank(MPI_COMM_WORLD, &my_id);
+    mpierr = MPI_Comm_size(MPI_COMM_WORLD, &npes);
+
+    // 4. Read options; everybody parses the same command line
+    for (it = 1; it < argc; it++)
+    {
+        string arg = argv[it];
+        if (arg.compare(0, 6, "--max=") == 0)
+            maxsize = atoll(arg.c_str() + 6);
+        else if (arg.compare(0, 8, "--iters=") == 0)
+            iters = atoi(arg.c_str() + 8);
+        else if (arg.compare(0, 7, "--peer=") == 0)
+            peer = atoi(arg.c_str() + 7);
+        else
+            maxsize = -1;
+    }
+    if (npes < 2 || peer < 1 || peer >= npes || maxsize < 1 || maxsize > (1LL << 30) || iters < 1)
+    {
+        if (my_id == 0)
+        {
+            cout << "Usage: mpirun -n <2 or more> " << argv[0] << " [--max=<bytes, up to 1 GiB>] [--iters=<int>] [--peer=<rank>]" << endl;
+        }
+        mpierr = MPI_Finalize();
+        return 1;
+    }
+
+    // 5. Ping-pong between PE 0 and the peer; everybody else just waits
+    if (my_id == 0 || my_id == peer)
+    {
+        other = (my_id == 0) ? peer : 0;
+        sbuf.assign(maxsize, 'a' + my_id % 26);
+        rbuf.assign(maxsize, 0);
+        t.resize(iters);
+        if (my_id == 0)
+        {
+            cout << "Ping-pong between PE 0 and PE " << peer << ". Latency is half a round trip (a whole exchange for sendrecv)." << endl;
+            cout << "mode,bytes,iters,min_us,p50_us,p90_us,p99_us,MB_per_s" << endl;
+        }
+        for (m = 0; m < NMODES; m++)
+        {
+            // one-way time of an iteration: half a round trip, except for an exchange
+            scale = (m == MODE_SENDRECV) ? 1.0 : 0.5;
+            for (size = 1; size <= maxsize; size *= 2)
+            {
+                // large messages take long enough that fewer iterations will do
+                nit = (size <= 65536) ? iters : min(iters, max(10, int(iters * 65536LL / size)));
+                nwarm = nit / 10 + 1;
+                if (m == MODE_PERSISTENT)
+                {
+                    mpierr = MPI_Recv_init(rbuf.data(), int(size), MPI_CHAR, other, 0, MPI_COMM_WORLD, &req[0]);
+                    mpierr = MPI_Send_init(sbuf.data(), int(size), MPI_CHAR, other, 0, MPI_COMM_WORLD, &req[1]);
+                }
+                // warm-up: connections, registration of the buffers, caches
+                for (it = 0; it < nwarm; it++)
+                {
+                    bounce(Mode(m), sbuf.data(), rbuf.data(), int(size), other, my_id == 0, req);
+                }
+                for (it = 0; it < nit; it++)
+                {
+                    t[it] = scale * bounce(Mode(m), sbuf.data(), rbuf.data(), int(size), other, my_id == 0, req);
+                }
+                if (m == MODE_PERSISTENT)
+                {
+                    mpierr = MPI_Request_free(&req[0]);
+                    mpierr = MPI_Request_free(&req[1]);
+                }
+                // percentiles of the iterations on PE 0
+                if (my_id == 0)
+                {
+                    sort(t.begin(), t.begin() + nit);
+                    p50 = t[nit / 2];
+                    cout << MODE_NAMES[m] << "," << size << "," << nit << fixed << setprecision(3);
+                    cout << "," << 1.0e6 * t[0] << "," << 1.0e6 * p50 << "," << 1.0e6 * t[nit * 9 / 10];
+                    cout << "," << 1.0e6 * t[nit * 99 / 100] << "," << size / p50 / 1.0e6 << defaultfloat << endl;
+                }
+            }
+        }
+    }
+
+    // 6. Close MPI communications
+    mpierr = MPI_Barrier(MPI_COMM_WORLD);
+    mpierr = MPI_Finalize();
+
+    // goodbye
+    return 0;
+}
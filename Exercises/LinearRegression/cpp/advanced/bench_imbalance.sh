@@ -0,0 +1,30 @@
+#!/bin/bash
+# Compare the static data decomposition (batched mode), the same with a
+# calibrated weighted partition, and dynamic manager-worker scheduling while
+# the last PE is artificially slowed down. search_time_s is the wall time of
+# the search (slowest PE), for the speedups; search_imbalance is the measured
+# max/avg of each PE's own RSS work, without the time spent waiting in the
+# reductions, for the even split of batched as well as the weighted one (the
+# engine's "predicted imbalance" line comes from the calibration pass only).
+# Usage: ./bench_imbalance.sh [PEs] [extra engine options...]
+# Writes CSV to stdout: mode,pes,imbalance,search_time_s,search_imbalance
+
+NP=${1:-4}
+shift
+EXE=./linreg_advanced_mpi.exe
+OPTS="--n=16777216 --na=40 --nb=40 --print=0 $*"
+
+# search time and measured search imbalance of one run, as "t,ratio"
+measure() {
+    mpirun -n $NP $EXE $OPTS "$@" | awk '/^Search time/ {t = $4}
+                                         /^Search work/ {r = $NF}
+                                         END {print t "," r}'
+}
+
+echo "mode,pes,imbalance,search_time_s,search_imbalance"
+for IMB in 1 1.5 2 4 8; do
+    for MODE in batched dynamic; do
+        echo "$MODE,$NP,$IMB,$(measure --mode=$MODE --imbalance=$IMB)"
+    done
+    echo "weighted,$NP,$IMB,$(measure --mode=batched --weights=calibrate --imbalance=$IMB)"
+done
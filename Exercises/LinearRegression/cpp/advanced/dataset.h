@@ -0,0 +1,126 @@
+/***
+ * File: dataset.h
+ * Description: Synthetic dataset: a noisy straight line
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 11:31:08 am
+ * Last Modified: Saturday, 17th October 2026, 11:31:10 am
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_DATASET_H
+#define LINREG_DATASET_H
+
+#include <cstdint>
+#include <vector>
+#include "philox.h"
+
+// What each PE knows about its share of the data: the global range of
+// points it owns and, unless the points are streamed, the points themselves
+struct Dataset
+{
+    long long start, stop;    // global indices start..stop-1 belong to this PE
+    double dx;                // control variable spacing
+    double at, bt;            // target parameters
+    uint64_t seed;            // random number generator seed
+    bool streaming;           // true: x and y are never stored whole; they are regenerated (or read
+                              // out of core) block by block
+    std::vector<double> x, y; // control and response variables (empty when streaming or in single precision)
+    std::vector<float> xf, yf; // single-precision storage (--precision=float; only yf with implicit)
+    const double *xp, *yp;    // where the double-precision points are: x and y, or a node-shared window
+
+    long long size() const { return stop - start; }
+};
+
+// Fill x and y with points start..stop-1 of the global dataset
+//     y = at*x + bt + gaussian noise,  x = i*dx
+// using nthreads OpenMP threads. The noise of point i comes from Philox
+// counter i/2 (points 2m and 2m+1 share one Box-Muller transform), so the
+// values depend only on the global index and the seed: the dataset is the
+// same whatever the number of PEs or threads.
+// T is double or float; the values are computed in double and rounded once.
+// x may be null when the control variable is not stored.
+template <typename T>
+inline void generate_slice(long long start, long long stop, double dx, double at, double bt,
+                           uint64_t seed, T *x, T *y, int nthreads)
+{
+    long long m, i;
+    double z[2];
+    int h;
+
+    if (stop <= start)
+    {
+        return;
+    }
+#pragma omp parallel for num_threads(nthreads) schedule(static) private(i, z, h)
+    for (m = start / 2; m <= (stop - 1) / 2; m++)
+    {
+        philox_gaussian_pair(m, seed, z[0], z[1]);
+        for (h = 0; h < 2; h++)
+        {
+            i = 2 * m + h;
+            if (i >= start && i < stop)
+            {
+                if (x != nullptr)
+                {
+                    x[i - start] = T(i * dx);
+                }
+                y[i - start] = T(at * (i * dx) + bt + z[h]);
+            }
+        }
+    }
+}
+
+// Fill x and y with points start..stop-1 of a polynomial dataset
+//     y = c[0] + c[1]*x + ... + c[d]*x^d + gaussian noise,  x = i*dx
+// with the same noise as generate_slice, so c = {bt, at} gives the points of
+// the straight-line dataset.
+inline void generate_poly_slice(long long start, long long stop, double dx, const std::vector<double> &c,
+                                uint64_t seed, double *x, double *y, int nthreads)
+{
+    long long m, i;
+    double z[2], xi, p;
+    int h, k;
+
+    if (stop <= start)
+    {
+        return;
+    }
+#pragma omp parallel for num_threads(nthreads) schedule(static) private(i, z, h, k, xi, p)
+    for (m = start / 2; m <= (stop - 1) / 2; m++)
+    {
+        philox_gaussian_pair(m, seed, z[0], z[1]);
+        for (h = 0; h < 2; h++)
+        {
+            i = 2 * m + h;
+            if (i >= start && i < stop)
+            {
+                xi = i * dx;
+                p = c.back();
+                for (k = (int)c.size() - 2; k >= 0; k--)
+                {
+                    p = p * xi + c[k];
+                }
+                x[i - start] = xi;
+                y[i - start] = p + z[h];
+            }
+        }
+    }
+}
+
+#endif
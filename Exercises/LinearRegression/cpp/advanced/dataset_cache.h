@@ -0,0 +1,115 @@
+/***
+ * File: dataset_cache.h
+ * Description: Cache of generated datasets, keyed by the generator parameters and checked with a checksum
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 9:14:33 pm
+ * Last Modified: Saturday, 17th October 2026, 9:14:36 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_DATASET_CACHE_H
+#define LINREG_DATASET_CACHE_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// A generated dataset depends only on (n, seed, at, bt), never on the
+// number of PEs, so one file per key serves runs of any size. The points
+// are stored in the dataset file format of dataset_io.h, so a cache file
+// also works as --input. A small text file next to it (same name plus
+// ".sum") repeats the key and holds the checksum of the points and the time
+// it took to generate them.
+struct CacheInfo
+{
+    uint64_t checksum; // sum over all points of point_hash(i, x, y), modulo 2^64
+    double tgen;       // seconds the run that wrote the cache spent generating the points
+};
+
+// Exact key in the file name: doubles are written as hexadecimal floats
+inline std::string cache_path(const std::string &dir, long long n, uint64_t seed, double at, double bt)
+{
+    char name[256];
+    snprintf(name, sizeof(name), "/linreg_%lld_%llu_%a_%a.bin", n, (unsigned long long)seed, at, bt);
+    return dir + name;
+}
+
+// Mix the index and the bits of a point into 64 bits (SplitMix64 finalizer)
+inline uint64_t point_hash(long long i, double x, double y)
+{
+    uint64_t bx, by, z;
+    memcpy(&bx, &x, sizeof(bx));
+    memcpy(&by, &y, sizeof(by));
+    z = (uint64_t)i * 0x9E3779B97F4A7C15ULL ^ bx ^ (by * 0xC2B2AE3D27D4EB4FULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Checksum of points start..stop-1. It is a plain sum, so the partial sums
+// of any split of the dataset add up to the same value (MPI_SUM on
+// MPI_UINT64_T), whatever the number of PEs.
+inline uint64_t slice_checksum(long long start, long long stop, const double *x, const double *y, int nthreads)
+{
+    uint64_t sum = 0;
+    long long i;
+#pragma omp parallel for num_threads(nthreads) schedule(static) reduction(+ : sum)
+    for (i = start; i < stop; i++)
+    {
+        sum += point_hash(i, x[i - start], y[i - start]);
+    }
+    return sum;
+}
+
+// Read the ".sum" file of a cache; false if it is missing or was written for another key
+inline bool read_cache_info(const std::string &path, long long n, uint64_t seed, double at, double bt, CacheInfo &info)
+{
+    FILE *f = fopen((path + ".sum").c_str(), "r");
+    long long fn;
+    unsigned long long fseed, fsum;
+    double fat, fbt, ftgen;
+    bool ok;
+    if (f == NULL)
+    {
+        return false;
+    }
+    ok = (fscanf(f, "%lld %llu %la %la %llu %la", &fn, &fseed, &fat, &fbt, &fsum, &ftgen) == 6);
+    fclose(f);
+    ok = ok && fn == n && fseed == seed && fat == at && fbt == bt;
+    if (ok)
+    {
+        info.checksum = fsum;
+        info.tgen = ftgen;
+    }
+    return ok;
+}
+
+inline bool write_cache_info(const std::string &path, long long n, uint64_t seed, double at, double bt, const CacheInfo &info)
+{
+    FILE *f = fopen((path + ".sum").c_str(), "w");
+    if (f == NULL)
+    {
+        return false;
+    }
+    fprintf(f, "%lld %llu %a %a %llu %a\n", n, (unsigned long long)seed, at, bt, (unsigned long long)info.checksum, info.tgen);
+    return fclose(f) == 0;
+}
+
+#endif
@@ -0,0 +1,201 @@
+/***
+ * File: dataset_io.h
+ * Description: Binary dataset files: collective MPI-IO and mmap
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 2:40:15 pm
+ * Last Modified: Saturday, 17th October 2026, 2:40:18 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_DATASET_IO_H
+#define LINREG_DATASET_IO_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <mpi.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// File layout (native byte order, no padding):
+//     char    magic[8]   "LINREG01"
+//     int64_t n          number of points
+//     double  x[n]       control variable
+//     double  y[n]       response variable
+// Keeping x and y in two contiguous columns means a PE's slice is two
+// contiguous ranges of the file, one per column.
+struct DatasetHeader
+{
+    char magic[8];
+    int64_t n;
+};
+const char DATASET_MAGIC[8] = {'L', 'I', 'N', 'R', 'E', 'G', '0', '1'};
+
+inline MPI_Offset x_offset(long long i) { return sizeof(DatasetHeader) + i * (MPI_Offset)sizeof(double); }
+inline MPI_Offset y_offset(long long n, long long i) { return sizeof(DatasetHeader) + (n + i) * (MPI_Offset)sizeof(double); }
+
+// Collective read or write of count doubles at offset, where count may not
+// fit in an int. MPI-4 libraries have large-count (_c) variants; older ones
+// get the transfer in pieces of IO_CHUNK doubles. Every PE must make the
+// same number of collective calls, so PEs that run out early join the
+// remaining ones with empty pieces. A transfer that moves fewer doubles than
+// asked for (a truncated file) counts as a failure.
+const long long IO_CHUNK = 1LL << 27; // 1 GiB of doubles per call
+
+inline bool transfer_all(MPI_File fh, MPI_Offset offset, double *buf, long long count, bool write, MPI_Comm comm)
+{
+    MPI_Status status;
+#if MPI_VERSION >= 4
+    MPI_Count done;
+    int err;
+    if (write)
+        err = MPI_File_write_at_all_c(fh, offset, buf, (MPI_Count)count, MPI_DOUBLE, &status);
+    else
+        err = MPI_File_read_at_all_c(fh, offset, buf, (MPI_Count)count, MPI_DOUBLE, &status);
+    return err == MPI_SUCCESS && MPI_Get_count_c(&status, MPI_DOUBLE, &done) == MPI_SUCCESS && done == count;
+#else
+    long long pieces = (count + IO_CHUNK - 1) / IO_CHUNK, maxpieces, p, first;
+    int len, done, err;
+    bool ok = true;
+    MPI_Allreduce(&pieces, &maxpieces, 1, MPI_LONG_LONG, MPI_MAX, comm);
+    for (p = 0; p < maxpieces; p++)
+    {
+        first = p * IO_CHUNK;
+        len = (first < count) ? (int)std::min(IO_CHUNK, count - first) : 0;
+        if (write)
+            err = MPI_File_write_at_all(fh, offset + first * (MPI_Offset)sizeof(double), buf + (len ? first : 0), len,
+                                        MPI_DOUBLE, &status);
+        else
+            err = MPI_File_read_at_all(fh, offset + first * (MPI_Offset)sizeof(double), buf + (len ? first : 0), len,
+                                       MPI_DOUBLE, &status);
+        ok = (err == MPI_SUCCESS && MPI_Get_count(&status, MPI_DOUBLE, &done) == MPI_SUCCESS && done == len) && ok;
+    }
+    return ok;
+#endif
+}
+
+// Every PE of comm gets the number of points in the file; -1 if the file
+// cannot be opened, is not a dataset file or is too short for its header's n
+inline long long read_dataset_size(const std::string &path, MPI_Comm comm)
+{
+    MPI_File fh;
+    MPI_Status status;
+    MPI_Offset size;
+    DatasetHeader hdr;
+    int done;
+    if (MPI_File_open(comm, path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+    {
+        return -1;
+    }
+    if (MPI_File_read_at_all(fh, 0, &hdr, sizeof(hdr), MPI_BYTE, &status) != MPI_SUCCESS ||
+        MPI_Get_count(&status, MPI_BYTE, &done) != MPI_SUCCESS || done != (int)sizeof(hdr))
+    {
+        hdr.n = -1;
+    }
+    if (MPI_File_get_size(fh, &size) != MPI_SUCCESS)
+    {
+        size = 0;
+    }
+    MPI_File_close(&fh);
+    if (hdr.n <= 0 || memcmp(hdr.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) != 0 || size < y_offset(hdr.n, hdr.n))
+    {
+        return -1;
+    }
+    return hdr.n;
+}
+
+// Collective read: each PE loads points start..stop-1 of both columns
+inline bool read_slice_mpiio(const std::string &path, long long n, long long start, long long stop,
+                             double *x, double *y, MPI_Comm comm)
+{
+    MPI_File fh;
+    bool ok;
+    if (MPI_File_open(comm, path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+    {
+        return false;
+    }
+    ok = transfer_all(fh, x_offset(start), x, stop - start, false, comm);
+    ok = transfer_all(fh, y_offset(n, start), y, stop - start, false, comm) && ok;
+    MPI_File_close(&fh);
+    return ok;
+}
+
+// Single-PE fallback: map the file and copy the slice out of the page cache
+inline bool read_slice_mmap(const std::string &path, long long n, long long start, long long stop,
+                            double *x, double *y)
+{
+    struct stat sb;
+    void *map;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (fstat(fd, &sb) != 0 || sb.st_size < y_offset(n, n))
+    {
+        close(fd);
+        return false;
+    }
+    map = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+    madvise(map, sb.st_size, MADV_SEQUENTIAL);
+    if (stop > start)
+    {
+        memcpy(x, (const char *)map + x_offset(start), (stop - start) * sizeof(double));
+        memcpy(y, (const char *)map + y_offset(n, start), (stop - start) * sizeof(double));
+    }
+    munmap(map, sb.st_size);
+    return true;
+}
+
+// Collective write of a dataset distributed as contiguous slices; PE 0 writes the header
+inline bool write_slice_mpiio(const std::string &path, long long n, long long start, long long stop,
+                              const double *x, const double *y, MPI_Comm comm)
+{
+    MPI_File fh;
+    DatasetHeader hdr;
+    int rank;
+    bool ok = true;
+
+    MPI_Comm_rank(comm, &rank);
+    if (MPI_File_open(comm, path.c_str(), MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+    {
+        return false;
+    }
+    MPI_File_set_size(fh, y_offset(n, n));
+    if (rank == 0)
+    {
+        memcpy(hdr.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+        hdr.n = n;
+        ok = (MPI_File_write_at(fh, 0, &hdr, sizeof(hdr), MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS);
+    }
+    ok = transfer_all(fh, x_offset(start), (double *)x, stop - start, true, comm) && ok;
+    ok = transfer_all(fh, y_offset(n, start), (double *)y, stop - start, true, comm) && ok;
+    MPI_File_close(&fh);
+    return ok;
+}
+
+#endif
@@ -0,0 +1,1354 @@
+/***
+ * File: linreg_advanced_mpi.cpp
+ * Description: MPI-parallelized Linear Regression engine with selectable search strategies
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 9:20:03 am
+ * Last Modified: Saturday, 17th October 2026, 9:20:05 am
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+/****
+ ***    This is NOT part of the workshop exercise. It starts from the
+ ***    code in /solution and adds alternative ways of doing each step,
+ ***    selected from the command line (run with --help to see them).
+ ***    Read /solution first.
+ ****/
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mpi.h>
+#include <omp.h>
+
+#include "options.h"
+#include "sufficient_stats.h"
+#include "rss_kernel.h"
+#include "rss_f32.h"
+#include "dataset.h"
+#include "streaming.h"
+#include "dataset_io.h"
+#include "dataset_cache.h"
+#include "timers.h"
+#include "partition.h"
+#include "solver.h"
+#include "pipeline.h"
+
+using namespace std;
+
+// Seconds this PE spent on its own share of the search (RSS passes plus any
+// artificial slowdown) since step 3 last reset it. Unlike the phase time, it
+// leaves out waiting for slower PEs in the reductions, so its max/avg over
+// PEs is the measured load imbalance.
+double tlocal = 0.0;
+
+// Artificial load imbalance for benchmarks: the last PE pretends to be
+// opt.imbalance times slower by spinning after each piece of work that took t seconds.
+// Every search calls it right after its local work, so it also adds that work to tlocal.
+void inject_imbalance(const Options &opt, double t)
+{
+    int myrank, nranks;
+    double until;
+    tlocal += t;
+    if (opt.imbalance <= 1.0)
+    {
+        return;
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    if (myrank == nranks - 1)
+    {
+        until = MPI_Wtime() + (opt.imbalance - 1.0) * t;
+        while (MPI_Wtime() < until)
+        {
+        }
+        tlocal += (opt.imbalance - 1.0) * t;
+    }
+}
+
+// Seconds per point of an RSS pass on this PE, for the weighted partition:
+// every PE scores the same CALIB_CANDIDATES candidates on the same
+// CALIB_POINTS points, best of 3. The artificial slowdown of --imbalance
+// counts, so a weighted partition can make up for it.
+const long long CALIB_POINTS = 1 << 18;
+const int CALIB_CANDIDATES = 16;
+double calibrate_pe(const Options &opt, rss_fn kernel)
+{
+    vector<double> x(CALIB_POINTS), y(CALIB_POINTS);
+    vector<double> as(CALIB_CANDIDATES), bs(CALIB_CANDIDATES), rss(CALIB_CANDIDATES);
+    double t0, t, best = 1.0e30;
+    int c, it;
+
+    generate_slice(0, CALIB_POINTS, 1.0 / CALIB_POINTS, opt.at, opt.bt, opt.seed, x.data(), y.data(), opt.threads);
+    for (c = 0; c < CALIB_CANDIDATES; c++)
+    {
+        as[c] = (c + 1) * opt.da;
+        bs[c] = (c + 1) * opt.db;
+    }
+    for (it = 0; it < 3; it++)
+    {
+        t0 = MPI_Wtime();
+        rss_candidates(kernel, x.data(), y.data(), CALIB_POINTS, as.data(), bs.data(), CALIB_CANDIDATES,
+                       opt.block, rss.data(), opt.threads);
+        inject_imbalance(opt, MPI_Wtime() - t0);
+        t = MPI_Wtime() - t0;
+        best = min(best, t);
+    }
+    return best / CALIB_POINTS;
+}
+
+// 3a. Same strategy as /solution: every candidate is broadcast and
+// its RSS is reduced on the manager, one candidate at a time
+void search_grid(const Options &opt, rss_fn kernel, const vector<double> &a, const vector<double> &b,
+                 const Dataset &data, int myrank, vector<double> &mse)
+{
+    int i, j;
+    double as, bs, rss, worldrss, t;
+
+    for (i = 0; i < opt.na; i++)
+    {
+        for (j = 0; j < opt.nb; j++)
+        {
+            if (myrank == 0)
+            {
+                as = a[i];
+                bs = b[j];
+            }
+            MPI_Bcast(&as, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            MPI_Bcast(&bs, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+            t = MPI_Wtime();
+            rss_candidates(kernel, data.xp, data.yp, data.size(), &as, &bs, 1, opt.block, &rss, opt.threads);
+            inject_imbalance(opt, MPI_Wtime() - t);
+
+            MPI_Reduce(&rss, &worldrss, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+            if (myrank == 0)
+            {
+                mse.push_back(worldrss / opt.n);
+            }
+        }
+    }
+}
+
+// 3b. Sufficient statistics: one pass over the data, one reduction,
+// then every candidate is scored by the manager in O(1)
+void search_stats(const Options &opt, const vector<double> &a, const vector<double> &b,
+                  const Dataset &data, int myrank, vector<double> &mse)
+{
+    int i, j;
+    Moments mine, world;
+
+    if (data.streaming)
+    {
+        mine = stream_moments(data, opt.block, opt.threads);
+    }
+    else
+    {
+        mine = local_moments(data.x, data.y, opt.threads);
+    }
+    reduce_moments(mine, world, 0, MPI_COMM_WORLD);
+
+    if (myrank == 0)
+    {
+        for (i = 0; i < opt.na; i++)
+        {
+            for (j = 0; j < opt.nb; j++)
+            {
+                mse.push_back(moments_rss(world, a[i], b[j]) / world.n);
+            }
+        }
+    }
+}
+
+// 3c. Batched: the parameter vectors are broadcast once, each PE computes
+// its partial RSS for a whole tile of candidates and the tile is combined
+// with a single vector reduction
+void search_batched(const Options &opt, rss_fn kernel, rss_f32_fn kernel32, vector<double> &a, vector<double> &b,
+                    const Dataset &data, int myrank, vector<double> &mse, PipelineStats &pst)
+{
+    int c, ncand, tile, first, count;
+    vector<double> as, bs; // candidates of the current tile
+    vector<double> myrss, worldrss;
+    double t;
+
+    // everybody needs the full parameter map now
+    a.resize(opt.na);
+    b.resize(opt.nb);
+    MPI_Bcast(a.data(), opt.na, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(b.data(), opt.nb, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // candidate c is (a[c / nb], b[c % nb]), the same order as the nested loops
+    ncand = opt.na * opt.nb;
+    tile = (opt.tile > 0 && opt.tile < ncand) ? opt.tile : ncand;
+    as.resize(tile);
+    bs.resize(tile);
+    myrss.resize(tile);
+    worldrss.resize(tile);
+    if (myrank == 0)
+    {
+        mse.reserve(ncand);
+    }
+
+    for (first = 0; first < ncand; first += tile)
+    {
+        count = min(tile, ncand - first);
+        for (c = 0; c < count; c++)
+        {
+            as[c] = a[(first + c) / opt.nb];
+            bs[c] = b[(first + c) % opt.nb];
+        }
+        // the whole tile is evaluated against one cache block of data at a time
+        t = MPI_Wtime();
+        if (opt.ooc > 0)
+        {
+            if (!pipeline_rss_candidates(kernel, data, opt.input, opt.n, as.data(), bs.data(), count, opt.ooc,
+                                         opt.depth, opt.block, myrss.data(), opt.threads, pst))
+            {
+                cout << "PE " << myrank << " cannot read its points from " << opt.input << endl;
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        else if (data.streaming)
+        {
+            stream_rss_candidates(kernel, data, as.data(), bs.data(), count, opt.block, myrss.data(), opt.threads);
+        }
+        else if (opt.precision != "double")
+        {
+            rss_candidates_f32(kernel32, data.xf.empty() ? nullptr : data.xf.data(), data.start * data.dx, data.dx,
+                               data.yf.data(), data.size(), as.data(), bs.data(), count, opt.block, myrss.data(), opt.threads);
+        }
+        else
+        {
+            rss_candidates(kernel, data.xp, data.yp, data.size(), as.data(), bs.data(), count,
+                           opt.block, myrss.data(), opt.threads);
+        }
+        inject_imbalance(opt, MPI_Wtime() - t);
+
+        if (opt.allreduce)
+        {
+            MPI_Allreduce(myrss.data(), worldrss.data(), count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        }
+        else
+        {
+            MPI_Reduce(myrss.data(), worldrss.data(), count, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        }
+        if (myrank == 0)
+        {
+            for (c = 0; c < count; c++)
+            {
+                mse.push_back(worldrss[c] / opt.n);
+            }
+        }
+    }
+}
+
+// 3d. Dynamic manager-worker scheduling: the grid is distributed instead of
+// the data. Every worker holds the whole dataset and asks the manager (PE 0)
+// for batches of candidates; it returns their RSSs with the next request.
+// Batches follow guided scheduling: remaining / (2 * workers), but never
+// fewer than opt.chunk, so they shrink as the grid runs out and a slow
+// worker cannot hold a big batch at the end.
+const int TAG_WORK = 1;   // manager -> worker: {first candidate, count}, count 0 means stop
+const int TAG_RESULT = 2; // worker -> manager: RSS of the last batch (empty on the first request)
+
+void search_dynamic(const Options &opt, rss_fn kernel, vector<double> &a, vector<double> &b,
+                    const Dataset &data, int myrank, int nranks, vector<double> &mse)
+{
+    int c, ncand, next, batch, count, active, worker;
+    int work[2];
+    vector<int> assigned; // first candidate of the batch each worker is busy with
+    vector<double> as, bs, rss;
+    MPI_Status status;
+    double t;
+
+    a.resize(opt.na);
+    b.resize(opt.nb);
+    MPI_Bcast(a.data(), opt.na, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(b.data(), opt.nb, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    ncand = opt.na * opt.nb;
+
+    if (myrank == 0)
+    {
+        mse.resize(ncand);
+        assigned.resize(nranks, 0);
+        rss.resize(ncand);
+        next = 0;
+        active = nranks - 1;
+        while (active > 0)
+        {
+            // whoever is done first gets served first
+            MPI_Recv(rss.data(), ncand, MPI_DOUBLE, MPI_ANY_SOURCE, TAG_RESULT, MPI_COMM_WORLD, &status);
+            worker = status.MPI_SOURCE;
+            MPI_Get_count(&status, MPI_DOUBLE, &count);
+            for (c = 0; c < count; c++)
+            {
+                mse[assigned[worker] + c] = rss[c] / opt.n;
+            }
+
+            batch = max(opt.chunk, (ncand - next) / (2 * (nranks - 1)));
+            work[0] = next;
+            work[1] = min(batch, ncand - next);
+            if (work[1] == 0)
+            {
+                active--;
+            }
+            assigned[worker] = next;
+            next += work[1];
+            MPI_Send(work, 2, MPI_INT, worker, TAG_WORK, MPI_COMM_WORLD);
+        }
+    }
+    else
+    {
+        work[1] = 0;
+        while (true)
+        {
+            MPI_Send(rss.data(), work[1], MPI_DOUBLE, 0, TAG_RESULT, MPI_COMM_WORLD);
+            MPI_Recv(work, 2, MPI_INT, 0, TAG_WORK, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            if (work[1] == 0)
+            {
+                break;
+            }
+            as.resize(work[1]);
+            bs.resize(work[1]);
+            rss.resize(work[1]);
+            for (c = 0; c < work[1]; c++)
+            {
+                as[c] = a[(work[0] + c) / opt.nb];
+                bs[c] = b[(work[0] + c) % opt.nb];
+            }
+            t = MPI_Wtime();
+            if (data.streaming)
+            {
+                stream_rss_candidates(kernel, data, as.data(), bs.data(), work[1], opt.block, rss.data(), opt.threads);
+            }
+            else
+            {
+                rss_candidates(kernel, data.xp, data.yp, data.size(), as.data(), bs.data(), work[1],
+                               opt.block, rss.data(), opt.threads);
+            }
+            inject_imbalance(opt, MPI_Wtime() - t);
+        }
+    }
+}
+
+// 3e. Pipelined: like 3a, one reduction per candidate, but the reduction of
+// candidate k is non-blocking and runs while candidate k+1 is computed.
+// At most opt.window reductions are in flight; each owns a slot of a ring
+// buffer, and a slot is only reused once its reduction completed. With
+// opt.persistent (MPI-4) the reductions of each slot are set up once with
+// MPI_Reduce_init and simply restarted.
+void search_pipelined(const Options &opt, rss_fn kernel, vector<double> &a, vector<double> &b,
+                      const Dataset &data, int myrank, vector<double> &mse)
+{
+    int k, s, ncand, window;
+    double as, bs, t;
+    vector<double> sendbuf, recvbuf;
+    vector<MPI_Request> req;
+    vector<int> owner; // candidate whose reduction a slot is carrying, -1 if none
+
+    a.resize(opt.na);
+    b.resize(opt.nb);
+    MPI_Bcast(a.data(), opt.na, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(b.data(), opt.nb, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    ncand = opt.na * opt.nb;
+    window = min(opt.window, ncand);
+    sendbuf.resize(window);
+    recvbuf.resize(window);
+    req.resize(window, MPI_REQUEST_NULL);
+    owner.resize(window, -1);
+    if (myrank == 0)
+    {
+        mse.resize(ncand);
+    }
+#if MPI_VERSION >= 4
+    if (opt.persistent)
+    {
+        for (s = 0; s < window; s++)
+        {
+            MPI_Reduce_init(&sendbuf[s], &recvbuf[s], 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD, MPI_INFO_NULL, &req[s]);
+        }
+    }
+#endif
+
+    for (k = 0; k < ncand; k++)
+    {
+        s = k % window;
+        if (owner[s] >= 0)
+        {
+            MPI_Wait(&req[s], MPI_STATUS_IGNORE);
+            if (myrank == 0)
+            {
+                mse[owner[s]] = recvbuf[s] / opt.n;
+            }
+        }
+
+        as = a[k / opt.nb];
+        bs = b[k % opt.nb];
+        t = MPI_Wtime();
+        rss_candidates(kernel, data.xp, data.yp, data.size(), &as, &bs, 1, opt.block, &sendbuf[s], opt.threads);
+        inject_imbalance(opt, MPI_Wtime() - t);
+
+#if MPI_VERSION >= 4
+        if (opt.persistent)
+        {
+            MPI_Start(&req[s]);
+        }
+        else
+#endif
+        {
+            MPI_Ireduce(&sendbuf[s], &recvbuf[s], 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD, &req[s]);
+        }
+        owner[s] = k;
+
+        // most libraries only progress collectives from inside MPI calls,
+        // so poke the oldest one in flight while we are here
+        s = (k + 1) % window;
+        if (owner[s] >= 0)
+        {
+            int done;
+            MPI_Test(&req[s], &done, MPI_STATUS_IGNORE);
+        }
+    }
+
+    // drain the window
+    for (k = max(0, ncand - window); k < ncand; k++)
+    {
+        s = k % window;
+        MPI_Wait(&req[s], MPI_STATUS_IGNORE);
+        if (myrank == 0)
+        {
+            mse[owner[s]] = recvbuf[s] / opt.n;
+        }
+    }
+#if MPI_VERSION >= 4
+    if (opt.persistent)
+    {
+        for (s = 0; s < window; s++)
+        {
+            MPI_Request_free(&req[s]);
+        }
+    }
+#endif
+}
+
+// 3f. 2D decomposition: the PEs form a datapes x parampes Cartesian grid.
+// Along the data axis the points are split, along the parameter axis the
+// candidates are. Each PE evaluates its block of candidates on its slice of
+// data, partial RSSs are summed along the data axis, and the best candidate
+// comes out of a single MPI_MINLOC reduction over everybody, so nobody has
+// to hold the whole MSE vector (it is only gathered on PE 0 to be printed).
+struct ProcessGrid
+{
+    MPI_Comm cart;      // the 2D Cartesian communicator
+    MPI_Comm datacomm;  // PEs sharing a block of candidates, each with a different data slice
+    MPI_Comm paramcomm; // PEs sharing a data slice, each with a different block of candidates
+    int datarank, datasize;
+    int paramrank, paramsize;
+};
+
+// The value/index pair MPI_MINLOC works on with MPI_DOUBLE_INT
+struct MinLoc
+{
+    double value;
+    int index;
+};
+
+void search_2d(const Options &opt, rss_fn kernel, vector<double> &a, vector<double> &b,
+               const Dataset &data, const ProcessGrid &pg, int myrank, vector<double> &mse, MinLoc &best)
+{
+    int c, ncand, cfirst, count;
+    long long first, stop;
+    vector<double> as, bs, myrss, rss;
+    vector<int> counts, displs;
+    MinLoc mine;
+    double t;
+
+    a.resize(opt.na);
+    b.resize(opt.nb);
+    MPI_Bcast(a.data(), opt.na, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(b.data(), opt.nb, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // my block of candidates
+    ncand = opt.na * opt.nb;
+    balanced_range(ncand, pg.paramsize, pg.paramrank, first, stop);
+    cfirst = first;
+    count = stop - first;
+    as.resize(count);
+    bs.resize(count);
+    myrss.resize(count);
+    rss.resize(count);
+    for (c = 0; c < count; c++)
+    {
+        as[c] = a[(cfirst + c) / opt.nb];
+        bs[c] = b[(cfirst + c) % opt.nb];
+    }
+
+    t = MPI_Wtime();
+    if (data.streaming)
+    {
+        stream_rss_candidates(kernel, data, as.data(), bs.data(), count, opt.block, myrss.data(), opt.threads);
+    }
+    else
+    {
+        rss_candidates(kernel, data.xp, data.yp, data.size(), as.data(), bs.data(), count,
+                       opt.block, myrss.data(), opt.threads);
+    }
+    inject_imbalance(opt, MPI_Wtime() - t);
+
+    // sum over the data axis: everybody in the column gets the full RSSs of its block
+    MPI_Allreduce(myrss.data(), rss.data(), count, MPI_DOUBLE, MPI_SUM, pg.datacomm);
+
+    mine.value = 1.0e300;
+    mine.index = cfirst;
+    for (c = 0; c < count; c++)
+    {
+        rss[c] = rss[c] / opt.n;
+        if (rss[c] < mine.value)
+        {
+            mine.value = rss[c];
+            mine.index = cfirst + c;
+        }
+    }
+    // ties go to the lowest index, the same as find_best
+    MPI_Allreduce(&mine, &best, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+
+    // only for printing: the first row of the process grid sends its blocks to PE 0
+    if (opt.print)
+    {
+        if (pg.datarank != 0)
+        {
+            count = 0;
+        }
+        if (myrank == 0)
+        {
+            mse.resize(ncand);
+            counts.resize(pg.paramsize * pg.datasize);
+            displs.resize(pg.paramsize * pg.datasize);
+        }
+        MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Gather(&cfirst, 1, MPI_INT, displs.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Gatherv(rss.data(), count, MPI_DOUBLE, mse.data(), counts.data(), displs.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+}
+
+// How far is a single-precision search from the double-precision one? The
+// dataset is regenerated block by block in double (as in streaming mode) and
+// every candidate of the last grid is scored again with the double kernel.
+void compare_precision(const Options &opt, rss_fn kernel, const vector<double> &a, const vector<double> &b,
+                       const Dataset &data, int myrank, const vector<double> &mse)
+{
+    int c, ncand = opt.na * opt.nb, best32 = 0, best64 = 0;
+    vector<double> as(ncand), bs(ncand), myrss(ncand), rss(ncand);
+    double rel, maxrel = 0.0;
+
+    for (c = 0; c < ncand; c++)
+    {
+        as[c] = a[c / opt.nb];
+        bs[c] = b[c % opt.nb];
+    }
+    stream_rss_candidates(kernel, data, as.data(), bs.data(), ncand, (opt.block > 0) ? opt.block : 4096,
+                          myrss.data(), opt.threads);
+    MPI_Reduce(myrss.data(), rss.data(), ncand, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (myrank == 0)
+    {
+        for (c = 0; c < ncand; c++)
+        {
+            rss[c] = rss[c] / opt.n;
+            rel = fabs(mse[c] - rss[c]) / rss[c];
+            maxrel = max(maxrel, rel);
+            if (mse[c] < mse[best32])
+            {
+                best32 = c;
+            }
+            if (rss[c] < rss[best64])
+            {
+                best64 = c;
+            }
+        }
+        cout << "Precision " << opt.precision << ": largest relative MSE difference from double " << maxrel;
+        cout << " over " << ncand << " candidates, ";
+        if (best32 == best64)
+        {
+            cout << "same best point" << endl;
+        }
+        else
+        {
+            cout << "double picks (a,b) = (" << as[best64] << "," << bs[best64] << ") with MSE = " << rss[best64] << endl;
+        }
+    }
+}
+
+// 4. The candidate with the smallest MSE; ties go to the first one in loop order
+double find_best(const Options &opt, const vector<double> &mse, int &best_i, int &best_j)
+{
+    int c, best = 0;
+    for (c = 1; c < opt.na * opt.nb; c++)
+    {
+        if (mse[c] < mse[best])
+        {
+            best = c;
+        }
+    }
+    best_i = best / opt.nb;
+    best_j = best % opt.nb;
+    return mse[best];
+}
+
+// Aggregate bandwidth of a collective read or write, as seen by the slowest PE.
+// Aborts if any PE failed.
+void report_io(bool ok, const char *what, const string &path, const string &method,
+               long long n, double t, int myrank, bool verbose)
+{
+    int mine = ok ? 1 : 0, all;
+    double tmax;
+    MPI_Allreduce(&mine, &all, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Reduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    if (myrank == 0)
+    {
+        if (all && verbose)
+        {
+            cout << what << " " << n << " points " << (what[0] == 'R' ? "from " : "to ") << path << " (" << method << ") in ";
+            cout << tmax << " s, " << 2.0 * sizeof(double) * n / tmax / 1.0e9 << " GB/s" << endl;
+        }
+        else if (!all)
+        {
+            cout << what << " " << path << " failed" << endl;
+        }
+    }
+    if (!all)
+    {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options opt;
+    vector<double> a, b; // parameters in each direction
+    Dataset data;        // this PE's share of the points
+    vector<double> mse;  // mean squared error of each candidate
+    double best_mse = numeric_limits<double>::max(); // best mse
+
+    // integer helpers
+    int i, j; // loops
+    int counter;
+    int best_i, best_j;
+
+    // RSS kernel and its bandwidth report
+    rss_fn kernel;         // kernel chosen for this CPU
+    rss_f32_fn kernel32;   // and its single-precision counterpart
+    string name32;
+    double ptbytes;        // bytes of x and y stored per point
+    double tsearch, tmax;  // time spent in step 3, on this PE and on the slowest
+    double tlocalmax, mywork[2], worksum[2]; // local work of step 3 (see tlocal): max, and sum and PEs that did some
+    double passes;         // times the local data is streamed from memory
+    double gbs_mem, gbs_eff;
+
+    // adaptive refinement
+    int level, more;   // levels done so far, whether to zoom in again
+    double spa, spb;   // grid spacing of the current level
+    double as, bs;     // center of the next level
+
+    // MPI variables
+    int myrank;   // rank id
+    int nranks;   // total number of ranks
+    int mpierr;   // return from MPI calls
+    int provided; // thread support level given by the library
+    MPI_Comm nodecomm;
+    int nodesize, nodeleader, nnodes;
+
+    // 2D decomposition
+    ProcessGrid pg;
+    int dims[2], periods[2] = {0, 0}, keep[2];
+    MinLoc best;
+    int partrank, partsize; // who splits the data, and how many ways
+
+    // Distributed task variables
+    long long mychunksize;     // number of loop iterations for each PE
+    long long mystart, mystop; // each PE start and stop iteration values
+
+    // weighted partition
+    double tcal;                  // seconds per point of the calibration pass on this PE
+    vector<double> tpe, weights;  // the same for every PE, and their weights
+    vector<double> before, after; // predicted search time of every PE with equal and weighted shares
+    long long pstart, pstop;
+
+    // node-shared dataset
+    MPI_Comm sharecomm = MPI_COMM_NULL; // the PEs of this node that hold the same points
+    MPI_Win win;
+    double *winbase;
+    MPI_Aint winbytes, winsize;
+    int sharerank, sharesize, color, dispunit;
+    double membytes[2], memtotal[2]; // dataset bytes on this PE with and without sharing
+    long long fillstart, fillstop;   // the points this PE generates or reads
+    double *xfill = nullptr, *yfill = nullptr; // and where they go (nowhere on PEs without points)
+
+    // dataset files
+    long long nfile; // number of points in the input file
+    double tio;      // time spent reading or writing it
+    bool ok;
+
+    // dataset cache
+    string cachefile;
+    CacheInfo cinfo;
+    uint64_t mysum, sum; // checksum of this PE's points and of all of them
+    double tgen;         // time spent generating the points
+    int hit, allok;
+
+    // out-of-core pipeline
+    PipelineStats pst, pstmax;
+
+    // iterative solver
+    SolverResult sol;
+    double tsolve, tsolvemax;
+
+    // phase timings; MPI_Wtime is not available before MPI_Init, so the init
+    // phase is timed with the C++ clock
+    chrono::steady_clock::time_point tstart = chrono::steady_clock::now();
+    double tphase[NPHASES] = {0.0}, t0, t1;
+    double tpick; // part of step 3 spent picking the best point of each level
+    int rep;   // repetition of steps 1-4
+    bool last; // only the last repetition prints
+
+    // start MPI
+    // Threads never call MPI themselves, only the master thread outside of
+    // parallel regions does, so FUNNELED is all we need
+    mpierr = MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    mpierr = MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    mpierr = MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    if (provided < MPI_THREAD_FUNNELED)
+    {
+        if (myrank == 0)
+        {
+            cout << "The MPI library does not support MPI_THREAD_FUNNELED" << endl;
+        }
+        mpierr = MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    // 0. Read options; everybody parses the same command line
+    if (!parse_options(argc, argv, opt))
+    {
+        if (myrank == 0)
+        {
+            print_usage(argv[0]);
+        }
+        mpierr = MPI_Finalize();
+        return 1;
+    }
+    if (opt.threads == 0)
+    {
+        opt.threads = omp_get_max_threads();
+    }
+
+    // Report the layout: PEs sharing memory are on the same node
+    mpierr = MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myrank, MPI_INFO_NULL, &nodecomm);
+    mpierr = MPI_Comm_size(nodecomm, &nodesize);
+    mpierr = MPI_Comm_rank(nodecomm, &nodeleader);
+    nodeleader = (nodeleader == 0) ? 1 : 0;
+    mpierr = MPI_Reduce(&nodeleader, &nnodes, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    mpierr = MPI_Comm_free(&nodecomm);
+    if (myrank == 0)
+    {
+        cout << "Layout: " << nnodes << " node(s), " << nodesize << " PE(s) on node 0, ";
+        cout << opt.threads << " thread(s) per PE" << endl;
+    }
+
+    kernel = select_rss_kernel(opt.kernel);
+    name32 = opt.kernel;
+    kernel32 = select_rss_f32_kernel(name32, opt.precision == "implicit");
+    if (opt.precision != "double")
+    {
+        opt.kernel = name32;
+    }
+    ptbytes = (opt.precision == "double") ? 2 * sizeof(double) : (opt.precision == "float") ? 2 * sizeof(float) : sizeof(float);
+
+    // Decide who holds which points; this and everything above is the init phase
+    if (!opt.input.empty())
+    {
+        nfile = read_dataset_size(opt.input, MPI_COMM_WORLD);
+        if (nfile <= 0)
+        {
+            if (myrank == 0)
+            {
+                cout << "Cannot read a dataset from " << opt.input << endl;
+            }
+            mpierr = MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        opt.n = nfile;
+    }
+    if (opt.mode == "dynamic")
+    {
+        // the grid is distributed instead: every worker needs all points
+        if (nranks < 2)
+        {
+            cout << "Dynamic mode needs a manager and at least one worker" << endl;
+            mpierr = MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        mychunksize = (myrank == 0) ? 0 : opt.n;
+        mystart = 0;
+    }
+    else
+    {
+        partrank = myrank;
+        partsize = nranks;
+        if (opt.mode == "2d")
+        {
+            // datapes x parampes process grid; without reordering PE 0 stays at (0,0)
+            if (opt.datapes > 0 && nranks % opt.datapes != 0)
+            {
+                if (myrank == 0)
+                {
+                    cout << "--datapes must divide the number of PEs" << endl;
+                }
+                mpierr = MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            dims[0] = opt.datapes;
+            dims[1] = 0;
+            mpierr = MPI_Dims_create(nranks, 2, dims);
+            mpierr = MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &pg.cart);
+            keep[0] = 1;
+            keep[1] = 0;
+            mpierr = MPI_Cart_sub(pg.cart, keep, &pg.datacomm);
+            keep[0] = 0;
+            keep[1] = 1;
+            mpierr = MPI_Cart_sub(pg.cart, keep, &pg.paramcomm);
+            mpierr = MPI_Comm_rank(pg.datacomm, &pg.datarank);
+            mpierr = MPI_Comm_size(pg.datacomm, &pg.datasize);
+            mpierr = MPI_Comm_rank(pg.paramcomm, &pg.paramrank);
+            mpierr = MPI_Comm_size(pg.paramcomm, &pg.paramsize);
+            partrank = pg.datarank;
+            partsize = pg.datasize;
+            if (myrank == 0)
+            {
+                cout << "Process grid: " << pg.datasize << " (data) x " << pg.paramsize << " (parameters)" << endl;
+            }
+        }
+        if (opt.weights.empty())
+        {
+            balanced_range(opt.n, partsize, partrank, mystart, mystop);
+        }
+        else
+        {
+            // Heterogeneous PEs: every PE times the same RSS pass, and each
+            // gets a share of the points proportional to its weight
+            tcal = calibrate_pe(opt, kernel);
+            tpe.resize(nranks);
+            mpierr = MPI_Allgather(&tcal, 1, MPI_DOUBLE, tpe.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+            if (opt.weights == "calibrate")
+            {
+                weights.resize(nranks);
+                for (i = 0; i < nranks; i++)
+                {
+                    weights[i] = 1.0 / tpe[i];
+                }
+            }
+            else if (!read_weights(opt.weights, weights, 0, MPI_COMM_WORLD))
+            {
+                if (myrank == 0)
+                {
+                    cout << "Cannot read " << nranks << " positive weights from " << opt.weights << endl;
+                }
+                mpierr = MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            weighted_range(opt.n, weights, partrank, mystart, mystop);
+
+            // what the calibration predicts for the search with either split
+            before.resize(nranks);
+            after.resize(nranks);
+            for (i = 0; i < nranks; i++)
+            {
+                balanced_range(opt.n, nranks, i, pstart, pstop);
+                before[i] = (pstop - pstart) * tpe[i];
+                weighted_range(opt.n, weights, i, pstart, pstop);
+                after[i] = (pstop - pstart) * tpe[i];
+            }
+            if (myrank == 0)
+            {
+                cout << "Weighted partition (" << opt.weights << "): predicted imbalance (max/avg) ";
+                cout << imbalance_ratio(before) << " with equal shares, " << imbalance_ratio(after) << " with weights";
+                cout << " (\"Search work\" below gives the measured value)" << endl;
+            }
+        }
+        mychunksize = mystop - mystart;
+    }
+    mystop = mystart + mychunksize;
+    data.start = mystart;
+    data.stop = mystop;
+    data.dx = 1.0 / double(opt.n); // we'll make x go from 0 to 1
+    data.at = opt.at;
+    data.bt = opt.bt;
+    data.seed = opt.seed;
+    data.streaming = opt.streaming || opt.ooc > 0;
+    data.xp = nullptr;
+    data.yp = nullptr;
+    fillstart = mystart;
+    fillstop = mystop;
+
+    // Node-shared dataset: the PEs of a node that hold the same points (all
+    // workers in dynamic mode, PEs with the same data slice in 2d mode)
+    // allocate them once with MPI_Win_allocate_shared. Each of them fills
+    // its own part of the slice in step 2, and they all read the whole slice
+    // in place.
+    if (opt.shared)
+    {
+        color = (opt.mode == "2d") ? pg.datarank : 0;
+        if (mychunksize == 0)
+        {
+            color = MPI_UNDEFINED; // the dynamic manager holds no points
+        }
+        mpierr = MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myrank, MPI_INFO_NULL, &nodecomm);
+        mpierr = MPI_Comm_split(nodecomm, color, myrank, &sharecomm);
+        mpierr = MPI_Comm_free(&nodecomm);
+        winbytes = 0;
+        if (sharecomm != MPI_COMM_NULL)
+        {
+            mpierr = MPI_Comm_rank(sharecomm, &sharerank);
+            mpierr = MPI_Comm_size(sharecomm, &sharesize);
+            winbytes = (sharerank == 0) ? 2 * mychunksize * (MPI_Aint)sizeof(double) : 0;
+            mpierr = MPI_Win_allocate_shared(winbytes, sizeof(double), MPI_INFO_NULL, sharecomm, &winbase, &win);
+            mpierr = MPI_Win_shared_query(win, 0, &winsize, &dispunit, &winbase);
+            mpierr = MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+            fillstart = mystart + mychunksize * sharerank / sharesize;
+            fillstop = mystart + mychunksize * (sharerank + 1) / sharesize;
+            data.xp = winbase;
+            data.yp = winbase + mychunksize;
+            xfill = winbase + (fillstart - mystart);
+            yfill = winbase + mychunksize + (fillstart - mystart);
+        }
+        // the window is all the dataset memory a shared PE allocates
+        membytes[0] = double(winbytes);
+        membytes[1] = 2.0 * sizeof(double) * mychunksize;
+        mpierr = MPI_Reduce(membytes, memtotal, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (myrank == 0)
+        {
+            cout << "Node-shared dataset: " << memtotal[0] / 1073741824.0 << " GiB on all PEs instead of ";
+            cout << memtotal[1] / 1073741824.0 << " GiB" << endl;
+        }
+    }
+    if (!opt.cache.empty())
+    {
+        cachefile = cache_path(opt.cache, opt.n, opt.seed, opt.at, opt.bt);
+    }
+    if (!opt.input.empty() || !opt.cache.empty())
+    {
+        // with a single PE there is nothing to coordinate, so map the file instead
+        if (opt.io == "mmap" || (opt.io == "auto" && nranks == 1))
+        {
+            opt.io = "mmap";
+        }
+        else
+        {
+            opt.io = "mpiio";
+        }
+    }
+    tphase[PHASE_INIT] = chrono::duration<double>(chrono::steady_clock::now() - tstart).count();
+
+    // Steps 1-4 are repeated --reps times for the phase timings; they all
+    // compute the same thing, and only the last repetition prints
+    for (rep = 0; rep < opt.reps; rep++)
+    {
+        last = (rep == opt.reps - 1);
+        mpierr = MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+
+        // 1. Build parameter map - square grid in (a,b) space
+        // Only the manager needs it
+        a.clear();
+        b.clear();
+        if (myrank == 0)
+        {
+            for (i = 0; i < opt.na; i++)
+            {
+                a.push_back((i + 1) * opt.da);
+            }
+            for (j = 0; j < opt.nb; j++)
+            {
+                b.push_back((j + 1) * opt.db);
+            }
+        }
+
+        // 2. Build points to fit (dataset), or load them from a file
+        // When streaming, the points are generated inside step 3 instead
+        if (!data.streaming && opt.precision == "double" && !opt.shared)
+        {
+            data.x.resize(mychunksize);
+            data.y.resize(mychunksize);
+            data.xp = data.x.data();
+            data.yp = data.y.data();
+            xfill = data.x.data();
+            yfill = data.y.data();
+        }
+        else if (!data.streaming && opt.precision != "double")
+        {
+            data.xf.resize((opt.precision == "float") ? mychunksize : 0);
+            data.yf.resize(mychunksize);
+        }
+        if (!opt.input.empty() && !data.streaming)
+        {
+            mpierr = MPI_Barrier(MPI_COMM_WORLD);
+            tio = MPI_Wtime();
+            if (opt.io == "mmap")
+            {
+                ok = read_slice_mmap(opt.input, opt.n, fillstart, fillstop, xfill, yfill);
+            }
+            else
+            {
+                ok = read_slice_mpiio(opt.input, opt.n, fillstart, fillstop, xfill, yfill, MPI_COMM_WORLD);
+            }
+            tio = MPI_Wtime() - tio;
+            report_io(ok, "Read", opt.input, opt.io, opt.n, tio, myrank, last);
+        }
+        else if (!opt.cache.empty())
+        {
+            // Dataset cache: read the points back if an earlier run saved them
+            // for the same (n, seed, at, bt) and they pass the checksum;
+            // generate and save them otherwise
+            hit = 0;
+            if (myrank == 0)
+            {
+                hit = read_cache_info(cachefile, opt.n, opt.seed, opt.at, opt.bt, cinfo) ? 1 : 0;
+            }
+            mpierr = MPI_Bcast(&hit, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            mpierr = MPI_Bcast(&cinfo, sizeof(CacheInfo), MPI_BYTE, 0, MPI_COMM_WORLD);
+            if (hit)
+            {
+                mpierr = MPI_Barrier(MPI_COMM_WORLD);
+                tio = MPI_Wtime();
+                if (opt.io == "mmap")
+                {
+                    ok = read_slice_mmap(cachefile, opt.n, fillstart, fillstop, xfill, yfill);
+                }
+                else
+                {
+                    ok = read_slice_mpiio(cachefile, opt.n, fillstart, fillstop, xfill, yfill, MPI_COMM_WORLD);
+                }
+                mysum = ok ? slice_checksum(fillstart, fillstop, xfill, yfill, opt.threads) : 0;
+                hit = ok ? 1 : 0;
+                mpierr = MPI_Allreduce(&hit, &allok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+                mpierr = MPI_Allreduce(&mysum, &sum, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+                tio = MPI_Wtime() - tio;
+                hit = (allok && sum == cinfo.checksum) ? 1 : 0;
+                if (myrank == 0 && last)
+                {
+                    if (hit)
+                    {
+                        cout << "Dataset cache hit: " << cachefile << " (" << opt.io << ") read and checked in " << tio;
+                        cout << " s, " << cinfo.tgen - tio << " s saved" << endl;
+                    }
+                    else
+                    {
+                        cout << "Dataset cache " << cachefile << " is damaged, generating the points again" << endl;
+                    }
+                }
+            }
+            if (!hit)
+            {
+                mpierr = MPI_Barrier(MPI_COMM_WORLD);
+                tgen = MPI_Wtime();
+                generate_slice(fillstart, fillstop, data.dx, data.at, data.bt, data.seed, xfill, yfill, opt.threads);
+                tgen = MPI_Wtime() - tgen;
+                mysum = slice_checksum(fillstart, fillstop, xfill, yfill, opt.threads);
+                mpierr = MPI_Allreduce(&tgen, &cinfo.tgen, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+                mpierr = MPI_Reduce(&mysum, &cinfo.checksum, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+                ok = write_slice_mpiio(cachefile, opt.n, fillstart, fillstop, xfill, yfill, MPI_COMM_WORLD);
+                hit = ok ? 1 : 0;
+                mpierr = MPI_Allreduce(&hit, &allok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+                // the ".sum" file goes last, so an interrupted write is a miss next time
+                if (myrank == 0 && allok)
+                {
+                    allok = write_cache_info(cachefile, opt.n, opt.seed, opt.at, opt.bt, cinfo) ? 1 : 0;
+                }
+                if (myrank == 0 && last)
+                {
+                    cout << "Dataset cache miss: generated in " << cinfo.tgen << " s, ";
+                    cout << (allok ? "saved to " : "could not save to ") << cachefile << endl;
+                }
+            }
+        }
+        else if (!data.streaming && opt.precision == "double")
+        {
+            generate_slice(fillstart, fillstop, data.dx, data.at, data.bt, data.seed, xfill, yfill, opt.threads);
+        }
+        else if (!data.streaming)
+        {
+            generate_slice(mystart, mystop, data.dx, data.at, data.bt, data.seed,
+                           data.xf.empty() ? (float *)nullptr : data.xf.data(), data.yf.data(), opt.threads);
+        }
+        if (!opt.output.empty() && !data.streaming)
+        {
+            mpierr = MPI_Barrier(MPI_COMM_WORLD);
+            tio = MPI_Wtime();
+            ok = write_slice_mpiio(opt.output, opt.n, mystart, mystop, data.xp, data.yp, MPI_COMM_WORLD);
+            tio = MPI_Wtime() - tio;
+            report_io(ok, "Wrote", opt.output, "mpiio", opt.n, tio, myrank, last);
+        }
+        if (sharecomm != MPI_COMM_NULL)
+        {
+            // every part of the slice is written before anybody reads it
+            mpierr = MPI_Win_sync(win);
+            mpierr = MPI_Barrier(sharecomm);
+            mpierr = MPI_Win_sync(win);
+        }
+        tphase[PHASE_DATA] += MPI_Wtime() - t0;
+
+        // 3. Explore parameter space
+        // With --levels > 1, the manager zooms in on the best cell after each
+        // level: the next grid has the same number of points, covers at least one
+        // old spacing on each side of the best point and contains the best point
+        // itself, so a level can never do worse than the previous one. It is
+        // broadcast to everybody.
+        mpierr = MPI_Barrier(MPI_COMM_WORLD);
+        pst = PipelineStats();
+        tsearch = MPI_Wtime();
+        tlocal = 0.0;
+        tpick = 0.0;
+        spa = opt.da;
+        spb = opt.db;
+        level = 0;
+        do
+        {
+            mse.clear();
+            if (opt.mode == "stats")
+            {
+                search_stats(opt, a, b, data, myrank, mse);
+            }
+            else if (opt.mode == "batched")
+            {
+                search_batched(opt, kernel, kernel32, a, b, data, myrank, mse, pst);
+            }
+            else if (opt.mode == "pipelined")
+            {
+                search_pipelined(opt, kernel, a, b, data, myrank, mse);
+            }
+            else if (opt.mode == "dynamic")
+            {
+                search_dynamic(opt, kernel, a, b, data, myrank, nranks, mse);
+            }
+            else if (opt.mode == "2d")
+            {
+                search_2d(opt, kernel, a, b, data, pg, myrank, mse, best);
+            }
+            else
+            {
+                search_grid(opt, kernel, a, b, data, myrank, mse);
+            }
+            level++;
+
+            t1 = MPI_Wtime();
+            if (myrank == 0)
+            {
+                if (opt.mode == "2d")
+                {
+                    best_mse = best.value;
+                    best_i = best.index / opt.nb;
+                    best_j = best.index % opt.nb;
+                }
+                else
+                {
+                    best_mse = find_best(opt, mse, best_i, best_j);
+                }
+            }
+            tpick += MPI_Wtime() - t1;
+
+            more = 0;
+            if (level < opt.levels)
+            {
+                if (myrank == 0)
+                {
+                    if (last)
+                    {
+                        cout << setprecision(12) << "Level " << level << ": best (a,b) = (" << a[best_i] << "," << b[best_j];
+                        cout << ") with MSE = " << best_mse << ", spacing (" << spa << "," << spb << ")" << setprecision(6) << endl;
+                    }
+                    if (spa > opt.tol || spb > opt.tol)
+                    {
+                        as = a[best_i];
+                        bs = b[best_j];
+                        for (i = 0; i < opt.na; i++)
+                        {
+                            a[i] = as + (i - (opt.na - 1) / 2) * spa / ((opt.na - 1) / 2);
+                        }
+                        for (j = 0; j < opt.nb; j++)
+                        {
+                            b[j] = bs + (j - (opt.nb - 1) / 2) * spb / ((opt.nb - 1) / 2);
+                        }
+                        more = 1;
+                    }
+                }
+                mpierr = MPI_Bcast(&more, 1, MPI_INT, 0, MPI_COMM_WORLD);
+                if (more)
+                {
+                    spa = spa / ((opt.na - 1) / 2);
+                    spb = spb / ((opt.nb - 1) / 2);
+                    a.resize(opt.na);
+                    b.resize(opt.nb);
+                    mpierr = MPI_Bcast(a.data(), opt.na, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+                    mpierr = MPI_Bcast(b.data(), opt.nb, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+                }
+            }
+        } while (more);
+        tsearch = MPI_Wtime() - tsearch;
+        tphase[PHASE_SEARCH] += tsearch - tpick;
+
+        mpierr = MPI_Reduce(&tsearch, &tmax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (myrank == 0 && last)
+        {
+            cout << "Search time (" << opt.mode << "): " << tmax << " s (slowest PE), ";
+            cout << 1.0e6 * tmax / (double(level) * opt.na * opt.nb) << " us per candidate" << endl;
+        }
+        // the dynamic manager does no RSS work, so the average is over the PEs that did
+        mywork[0] = tlocal;
+        mywork[1] = (tlocal > 0.0) ? 1.0 : 0.0;
+        mpierr = MPI_Reduce(&tlocal, &tlocalmax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        mpierr = MPI_Reduce(mywork, worksum, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (myrank == 0 && last && worksum[0] > 0.0)
+        {
+            cout << "Search work (RSS passes, no waiting): " << tlocalmax << " s (slowest PE), measured imbalance (max/avg) ";
+            cout << tlocalmax * worksum[1] / worksum[0] << endl;
+        }
+
+        // How close did the RSS passes get to memory bandwidth? Without blocking
+        // every candidate streams x and y again; with blocking each tile of
+        // candidates streams them once. The effective rate counts every byte each
+        // candidate touched, including the ones served from cache.
+        // Streamed points never touch memory, so there is nothing to compare.
+        if (opt.streaming && myrank == 0 && last)
+        {
+            cout << "Streamed " << opt.n << " points in blocks of " << opt.block << " with ";
+            cout << 2 * sizeof(double) * opt.block * opt.threads / 1024 << " KiB of buffers per PE" << endl;
+        }
+        if ((opt.mode == "grid" || opt.mode == "batched" || opt.mode == "pipelined") && !data.streaming)
+        {
+            if (opt.stream <= 0.0)
+            {
+                opt.stream = stream_triad_gbs(1 << 22, 5, opt.threads, MPI_COMM_WORLD);
+            }
+            if (opt.mode == "batched" && opt.block > 0)
+            {
+                passes = level * ((opt.tile > 0) ? ceil(double(opt.na) * opt.nb / opt.tile) : 1.0);
+            }
+            else
+            {
+                passes = level * double(opt.na) * opt.nb;
+            }
+            gbs_mem = ptbytes * data.size() * passes / tsearch / 1.0e9;
+            gbs_eff = ptbytes * data.size() * level * opt.na * opt.nb / tsearch / 1.0e9;
+            if (myrank == 0 && last)
+            {
+                cout << "RSS kernel " << opt.kernel << " (" << opt.precision << "): PE 0 memory traffic " << gbs_mem << " GB/s, effective " << gbs_eff << " GB/s";
+                cout << ", STREAM triad " << opt.stream << " GB/s (" << 100.0 * gbs_mem / opt.stream << "% of bound)" << endl;
+            }
+        }
+
+        // Out of core, how well did loading hide behind the kernels? With full
+        // overlap the wall time is the larger of the two, not their sum.
+        if (opt.ooc > 0)
+        {
+            mpierr = MPI_Reduce(&pst.tio, &pstmax.tio, PIPELINE_STATS_LEN, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+            if (myrank == 0 && last)
+            {
+                cout << "Out-of-core pipeline (" << (opt.input.empty() ? "generated" : opt.input) << "): " << pstmax.chunks;
+                cout << " chunk(s) of " << opt.ooc << " points, depth " << opt.depth << ", ";
+                cout << 2.0 * sizeof(double) * opt.ooc * opt.depth / 1048576.0 << " MiB of buffers per PE" << endl;
+                cout << "  max over PEs: load " << pstmax.tio << " s, compute " << pstmax.tcompute << " s, waiting ";
+                cout << pstmax.tstall << " s, wall " << pstmax.twall << " s (";
+                cout << pstmax.twall / max(pstmax.tio, pstmax.tcompute) << "x the slower stage, ";
+                cout << pstmax.twall / (pstmax.tio + pstmax.tcompute) << "x their sum)" << endl;
+            }
+        }
+
+        if (opt.precision != "double" && last)
+        {
+            compare_precision(opt, kernel, a, b, data, myrank, mse);
+        }
+
+        // 4. Look for best combination of (a,b)
+        // The best point of each level was already picked in step 3; that time
+        // counts as selection too
+        t0 = MPI_Wtime();
+        if (myrank == 0 && last)
+        {
+            if (opt.print)
+            {
+                counter = 0;
+                for (i = 0; i < opt.na; i++)
+                {
+                    for (j = 0; j < opt.nb; j++)
+                    {
+                        cout << "(a,b) = (" << a[i] << "," << b[j] << ")      MSE = " << mse[counter] << endl;
+                        counter++;
+                    }
+                }
+            }
+            if (opt.levels > 1)
+            {
+                cout << setprecision(12);
+            }
+            cout << "\n\nBest fit is for (a,b) = (" << a[best_i] << "," << b[best_j] << ")";
+            cout << " with MSE = " << best_mse << endl;
+        }
+        tphase[PHASE_SELECT] += tpick + MPI_Wtime() - t0;
+    }
+    for (i = PHASE_DATA; i < NPHASES; i++)
+    {
+        tphase[i] = tphase[i] / opt.reps;
+    }
+
+    // 5. The same fit with an iterative solver: one MPI_Allreduce per
+    // iteration instead of one reduction per grid point, and no grid
+    // resolution limit. Starts from (0,0) on the last repetition's points.
+    if (opt.solver != "none")
+    {
+        mpierr = MPI_Barrier(MPI_COMM_WORLD);
+        tsolve = MPI_Wtime();
+        sol = solve_line(opt.solver, data.xp, data.yp, data.size(), 0.0, 0.0, opt.maxiter, opt.soltol,
+                         opt.batch, opt.seed, opt.threads, MPI_COMM_WORLD);
+        tsolve = MPI_Wtime() - tsolve;
+        mpierr = MPI_Reduce(&tsolve, &tsolvemax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (myrank == 0)
+        {
+            cout << setprecision(12);
+            cout << "\nSolver " << opt.solver << ": " << sol.iters << " iteration(s)" << (sol.converged ? "" : " (not converged)");
+            cout << " in " << tsolvemax << " s, (a,b) = (" << sol.a << "," << sol.b << ") with MSE = " << sol.mse << endl;
+            cout << "Grid search: " << tmax << " s, MSE = " << best_mse << " (solver MSE - grid MSE = ";
+            cout << sol.mse - best_mse << ")" << setprecision(6) << endl;
+        }
+    }
+    report_phases(tphase, opt.reps, 0, MPI_COMM_WORLD);
+
+    // clean up and good bye
+    if (sharecomm != MPI_COMM_NULL)
+    {
+        mpierr = MPI_Win_unlock_all(win);
+        mpierr = MPI_Win_free(&win);
+        mpierr = MPI_Comm_free(&sharecomm);
+    }
+    if (opt.mode == "2d")
+    {
+        mpierr = MPI_Comm_free(&pg.datacomm);
+        mpierr = MPI_Comm_free(&pg.paramcomm);
+        mpierr = MPI_Comm_free(&pg.cart);
+    }
+    mpierr = MPI_Finalize();
+    return 0;
+}
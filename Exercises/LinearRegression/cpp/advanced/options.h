@@ -0,0 +1,346 @@
+/***
+ * File: options.h
+ * Description: Command-line options for the advanced Linear Regression engine
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 9:02:11 am
+ * Last Modified: Saturday, 17th October 2026, 9:02:14 am
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_OPTIONS_H
+#define LINREG_OPTIONS_H
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <climits>
+#include <mpi.h>
+
+// All knobs of the engine, with defaults matching the /solution code
+struct Options
+{
+    // parameter map
+    int na = 10, nb = 10;      // number of points for each parameter in grid space
+    double da = 0.1, db = 0.1; // grid spacing in each direction
+    int levels = 1;            // adaptive refinement: maximum number of grids, each zoomed on the previous best
+    double tol = 0.0;          // adaptive refinement: stop once both spacings are this small
+
+    // target straight line
+    long long n = 1 << 27;     // number of "data" points (64-bit: datasets may exceed 2^31)
+    double at = 0.5, bt = 0.5; // target parameters
+    unsigned long long seed = 0; // key of the counter-based random number generator
+
+    // dataset files
+    std::string input = "";    // read the points from this file instead of generating them
+    std::string output = "";   // write the generated points to this file
+    std::string io = "auto";   // how to read input or the cache: auto | mpiio | mmap
+    std::string cache = "";    // directory of the dataset cache (empty: no cache)
+
+    // how step 3 is carried out
+    std::string mode = "grid"; // grid: one reduction per candidate, stats: sufficient statistics,
+                               // batched: one vector reduction per tile of candidates,
+                               // dynamic: manager hands out batches of candidates to workers,
+                               // pipelined: one non-blocking reduction per candidate,
+                               // 2d: data and candidates split over a 2D process grid
+    int tile = 0;              // candidates per vector reduction in batched mode (0: whole grid)
+    bool allreduce = false;    // batched mode combines tiles with MPI_Allreduce instead of MPI_Reduce
+    int chunk = 1;             // smallest batch the manager hands out in dynamic mode
+    double imbalance = 1.0;    // benchmarks only: the last PE runs this many times slower
+    std::string weights = "";  // share of the points of each PE: a file with one weight per PE,
+                               // "calibrate" to measure them, empty for equal shares
+    int window = 8;            // reductions in flight in pipelined mode
+    bool persistent = false;   // pipelined mode uses MPI-4 persistent collectives
+    int datapes = 0;           // PEs along the data axis in 2d mode (0: let MPI_Dims_create choose)
+    bool print = true;         // print the MSE of every candidate
+    bool streaming = false;    // generate the data block by block inside step 3, never store it
+    long long ooc = 0;         // batched mode out of core: points per chunk (0: hold the whole slice)
+    int depth = 2;             // chunk buffers of the out-of-core pipeline (2: double buffering)
+    bool shared = false;       // dynamic and 2d modes: one copy of the replicated points per node
+
+    // RSS kernel
+    std::string kernel = "auto"; // auto | scalar | sse2 | avx2 | avx512
+    int block = 4096;            // data points per cache block (0: no blocking)
+    double stream = 0.0;         // STREAM bandwidth per PE in GB/s (0: measure it)
+    std::string precision = "double"; // double | float | implicit (float y, x recomputed), batched mode only
+
+    // iterative solver run after the grid search, for comparison
+    std::string solver = "none"; // none | gd | newton | sgd
+    int maxiter = 10000;         // iterations before the solver gives up
+    double soltol = 0.0;         // stop once a and b move by less than this (0: 1e-10, or 3e-3 for sgd)
+    int batch = 1024;            // points per PE and iteration in sgd
+
+    // hybrid MPI + threads
+    int threads = 1; // OpenMP threads per PE (0: whatever OMP_NUM_THREADS says)
+
+    // benchmarking
+    int reps = 1; // run steps 1-4 this many times and average the phase timings
+};
+
+// Print the list of accepted options
+inline void print_usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " [--key=value ...]\n"
+              << "  --n=<int>           number of data points\n"
+              << "  --na=<int>          number of grid points for a\n"
+              << "  --nb=<int>          number of grid points for b\n"
+              << "  --da=<double>       grid spacing for a\n"
+              << "  --db=<double>       grid spacing for b\n"
+              << "  --levels=<int>      maximum number of coarse-to-fine refinement levels\n"
+              << "  --tol=<double>      stop refining once both grid spacings are below this\n"
+              << "  --at=<double>       target slope\n"
+              << "  --bt=<double>       target intercept\n"
+              << "  --seed=<int>        random number generator seed\n"
+              << "  --input=<path>      read the dataset from a binary file (n comes from the file)\n"
+              << "  --output=<path>     write the generated dataset to a binary file\n"
+              << "  --io=<string>       auto | mpiio | mmap (auto: mmap with a single PE)\n"
+              << "  --cache=<dir>       reuse generated datasets saved in this directory\n"
+              << "  --mode=<string>     grid | stats | batched | dynamic | pipelined | 2d\n"
+              << "  --tile=<int>        candidates per reduction in batched mode (0: whole grid)\n"
+              << "  --allreduce=<0|1>   use MPI_Allreduce in batched mode\n"
+              << "  --chunk=<int>       smallest batch of candidates in dynamic mode\n"
+              << "  --imbalance=<double> make the last PE this many times slower (benchmarks)\n"
+              << "  --weights=<path>    split the points by per-PE weights from a file, or \"calibrate\"\n"
+              << "  --window=<int>      reductions in flight in pipelined mode\n"
+              << "  --persistent=<0|1>  use MPI_Reduce_init in pipelined mode (MPI-4 only)\n"
+              << "  --datapes=<int>     PEs along the data axis in 2d mode (0: automatic)\n"
+              << "  --print=<0|1>       print the MSE of every candidate\n"
+              << "  --streaming=<0|1>   never store the dataset (not in grid or pipelined modes)\n"
+              << "  --ooc=<int>         batched mode: read or generate the slice in chunks of this many\n"
+              << "                      points in a background thread (0: hold the whole slice)\n"
+              << "  --depth=<int>       chunk buffers of the out-of-core pipeline (at least 2)\n"
+              << "  --shared=<0|1>      keep one copy of the dataset per node (dynamic and 2d modes)\n"
+              << "  --kernel=<string>   auto | scalar | sse2 | avx2 | avx512\n"
+              << "  --block=<int>       data points per cache block (0: no blocking)\n"
+              << "  --stream=<double>   STREAM bandwidth per PE in GB/s (0: measure it)\n"
+              << "  --precision=<string> double | float | implicit (batched mode, generated data, one level)\n"
+              << "  --solver=<string>   none | gd | newton | sgd: also fit with an iterative solver\n"
+              << "  --maxiter=<int>     maximum solver iterations\n"
+              << "  --soltol=<double>   solver tolerance on the change of a and b (0: per solver)\n"
+              << "  --batch=<int>       points per PE and iteration in sgd\n"
+              << "  --threads=<int>     OpenMP threads per PE (0: OMP_NUM_THREADS)\n"
+              << "  --reps=<int>        repeat steps 1-4 and average the phase timings" << std::endl;
+}
+
+// Parse --key=value pairs into opt. Returns false on anything it does not understand.
+inline bool parse_options(int argc, char *argv[], Options &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos)
+        {
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string val = arg.substr(eq + 1);
+
+        if (key == "n")
+            opt.n = atoll(val.c_str());
+        else if (key == "na")
+            opt.na = atoi(val.c_str());
+        else if (key == "nb")
+            opt.nb = atoi(val.c_str());
+        else if (key == "da")
+            opt.da = atof(val.c_str());
+        else if (key == "db")
+            opt.db = atof(val.c_str());
+        else if (key == "levels")
+            opt.levels = atoi(val.c_str());
+        else if (key == "tol")
+            opt.tol = atof(val.c_str());
+        else if (key == "at")
+            opt.at = atof(val.c_str());
+        else if (key == "bt")
+            opt.bt = atof(val.c_str());
+        else if (key == "seed")
+            opt.seed = strtoull(val.c_str(), NULL, 10);
+        else if (key == "input")
+            opt.input = val;
+        else if (key == "output")
+            opt.output = val;
+        else if (key == "io")
+            opt.io = val;
+        else if (key == "mode")
+            opt.mode = val;
+        else if (key == "tile")
+            opt.tile = atoi(val.c_str());
+        else if (key == "chunk")
+            opt.chunk = atoi(val.c_str());
+        else if (key == "imbalance")
+            opt.imbalance = atof(val.c_str());
+        else if (key == "weights")
+            opt.weights = val;
+        else if (key == "window")
+            opt.window = atoi(val.c_str());
+        else if (key == "persistent")
+            opt.persistent = (atoi(val.c_str()) != 0);
+        else if (key == "datapes")
+            opt.datapes = atoi(val.c_str());
+        else if (key == "allreduce")
+            opt.allreduce = (atoi(val.c_str()) != 0);
+        else if (key == "kernel")
+            opt.kernel = val;
+        else if (key == "block")
+            opt.block = atoi(val.c_str());
+        else if (key == "stream")
+            opt.stream = atof(val.c_str());
+        else if (key == "threads")
+            opt.threads = atoi(val.c_str());
+        else if (key == "ooc")
+            opt.ooc = atoll(val.c_str());
+        else if (key == "depth")
+            opt.depth = atoi(val.c_str());
+        else if (key == "streaming")
+            opt.streaming = (atoi(val.c_str()) != 0);
+        else if (key == "cache")
+            opt.cache = val;
+        else if (key == "shared")
+            opt.shared = (atoi(val.c_str()) != 0);
+        else if (key == "print")
+            opt.print = (atoi(val.c_str()) != 0);
+        else if (key == "precision")
+            opt.precision = val;
+        else if (key == "solver")
+            opt.solver = val;
+        else if (key == "maxiter")
+            opt.maxiter = atoi(val.c_str());
+        else if (key == "soltol")
+            opt.soltol = atof(val.c_str());
+        else if (key == "batch")
+            opt.batch = atoi(val.c_str());
+        else if (key == "reps")
+            opt.reps = atoi(val.c_str());
+        else
+            return false;
+    }
+    // candidates are still counted with int, as are MPI counts of RSS vectors
+    if (opt.na > 0 && opt.nb > INT_MAX / opt.na)
+    {
+        return false;
+    }
+    if (opt.n <= 0 || opt.na <= 0 || opt.nb <= 0 || opt.tile < 0 || opt.block < 0 || opt.threads < 0 || opt.reps < 1)
+    {
+        return false;
+    }
+    if (opt.mode != "grid" && opt.mode != "stats" && opt.mode != "batched" && opt.mode != "dynamic" && opt.mode != "pipelined" && opt.mode != "2d")
+    {
+        return false;
+    }
+    // dynamic batches, pipelined windows and 2d data PEs need sane sizes
+    if (opt.chunk < 1 || opt.window < 1 || opt.datapes < 0)
+    {
+        return false;
+    }
+    // in dynamic and 2d modes several PEs hold the same points, so they cannot write slices of them
+    if ((opt.mode == "dynamic" || opt.mode == "2d") && !opt.output.empty())
+    {
+        return false;
+    }
+    // zooming keeps the best point and one old spacing on each side of it,
+    // which only shrinks the spacing with at least 5 points per direction
+    if (opt.levels < 1 || (opt.levels > 1 && (opt.na < 5 || opt.nb < 5)))
+    {
+        return false;
+    }
+    if (opt.io != "auto" && opt.io != "mpiio" && opt.io != "mmap")
+    {
+        return false;
+    }
+    // a file cannot be streamed through the generator, nor can a streamed dataset be written
+    if (opt.streaming && (!opt.input.empty() || !opt.output.empty()))
+    {
+        return false;
+    }
+    // streaming regenerates the data on every pass, which would happen once
+    // per candidate in grid and pipelined modes
+    if (opt.streaming && (opt.mode == "grid" || opt.mode == "pipelined"))
+    {
+        return false;
+    }
+    // single-precision storage only has a batched kernel, and files are always double
+    if (opt.precision != "double" && opt.precision != "float" && opt.precision != "implicit")
+    {
+        return false;
+    }
+    if (opt.precision != "double" && (opt.mode != "batched" || opt.streaming || !opt.input.empty() || !opt.output.empty()))
+    {
+        return false;
+    }
+    // the single-precision kernels round a and b to float, so refined grids
+    // would soon collapse into repeated candidates
+    if (opt.precision != "double" && opt.levels > 1)
+    {
+        return false;
+    }
+    // the cache is written as disjoint slices of a generated double-precision dataset
+    if (!opt.cache.empty() && (opt.mode == "dynamic" || opt.mode == "2d" || opt.streaming ||
+                               !opt.input.empty() || !opt.output.empty() || opt.precision != "double"))
+    {
+        return false;
+    }
+    // weights split the points among all PEs, so every PE must hold a disjoint slice
+    if (!opt.weights.empty() && (opt.mode == "dynamic" || opt.mode == "2d"))
+    {
+        return false;
+    }
+    if (opt.solver != "none" && opt.solver != "gd" && opt.solver != "newton" && opt.solver != "sgd")
+    {
+        return false;
+    }
+    // the solver reduces over all PEs, so it needs disjoint slices of stored double-precision points
+    if (opt.solver != "none" && (opt.mode == "dynamic" || opt.mode == "2d" || opt.streaming ||
+                                 opt.precision != "double" || opt.maxiter < 1 || opt.batch < 1 || opt.soltol < 0.0))
+    {
+        return false;
+    }
+    // sgd averages stop moving only down to their sampling noise
+    if (opt.soltol == 0.0)
+    {
+        opt.soltol = (opt.solver == "sgd") ? 3.0e-3 : 1.0e-10;
+    }
+    // the out-of-core pipeline replaces the stored slice in batched mode; it can
+    // read an input file but not produce one, and it keeps no points to share or solve on
+    if (opt.ooc < 0 || opt.depth < 2)
+    {
+        return false;
+    }
+    if (opt.ooc > 0 && (opt.mode != "batched" || opt.streaming || opt.precision != "double" || !opt.output.empty() ||
+                        !opt.cache.empty() || opt.shared || opt.solver != "none"))
+    {
+        return false;
+    }
+    // only these modes hold the same points on several PEs
+    if (opt.shared && ((opt.mode != "dynamic" && opt.mode != "2d") || opt.streaming))
+    {
+        return false;
+    }
+    // streaming needs a finite block
+    if (opt.streaming && opt.block == 0)
+    {
+        opt.block = 4096;
+    }
+#if MPI_VERSION < 4
+    // persistent collectives arrived with MPI-4; fall back to MPI_Ireduce
+    opt.persistent = false;
+#endif
+    return true;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/***
+ * File: partition.h
+ * Description: Balanced and weighted block decomposition of the data points
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 9:41:07 pm
+ * Last Modified: Saturday, 17th October 2026, 9:41:09 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_PARTITION_H
+#define LINREG_PARTITION_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <mpi.h>
+
+// Block part of nparts of n items. The first n % nparts blocks get one extra
+// item, so no two blocks differ by more than one (instead of handing the
+// whole leftover to the last one).
+inline void balanced_range(long long n, int nparts, int part, long long &start, long long &stop)
+{
+    long long q = n / nparts, r = n % nparts;
+    start = part * q + std::min((long long)part, r);
+    stop = start + q + ((part < r) ? 1 : 0);
+}
+
+// Block part of nparts of n items, in proportion to the weights w (all > 0).
+// The boundaries are rounded prefix sums of the weights, so the blocks are
+// contiguous, cover all n items and no block is off its share by more than one.
+inline void weighted_range(long long n, const std::vector<double> &w, int part, long long &start, long long &stop)
+{
+    long double total = 0.0, before = 0.0;
+    int p;
+    for (p = 0; p < (int)w.size(); p++)
+    {
+        total += w[p];
+        if (p < part)
+        {
+            before += w[p];
+        }
+    }
+    start = (part == 0) ? 0 : (long long)(n * (before / total) + 0.5L);
+    stop = (part == (int)w.size() - 1) ? n : (long long)(n * ((before + w[part]) / total) + 0.5L);
+}
+
+// Relative speed of each PE of comm from a text file with one positive
+// weight per line, in rank order. Root reads it and broadcasts the weights.
+// Returns false, on every PE, if the file is missing, short or has a weight <= 0.
+inline bool read_weights(const std::string &path, std::vector<double> &w, int root, MPI_Comm comm)
+{
+    int myrank, nranks, p, ok = 1;
+    FILE *f;
+
+    MPI_Comm_rank(comm, &myrank);
+    MPI_Comm_size(comm, &nranks);
+    w.assign(nranks, 0.0);
+    if (myrank == root)
+    {
+        f = fopen(path.c_str(), "r");
+        ok = (f != NULL) ? 1 : 0;
+        for (p = 0; ok && p < nranks; p++)
+        {
+            ok = (fscanf(f, "%lf", &w[p]) == 1 && w[p] > 0.0) ? 1 : 0;
+        }
+        if (f != NULL)
+        {
+            fclose(f);
+        }
+    }
+    MPI_Bcast(&ok, 1, MPI_INT, root, comm);
+    MPI_Bcast(w.data(), nranks, MPI_DOUBLE, root, comm);
+    return ok != 0;
+}
+
+// Load imbalance of a phase: time of the slowest PE over the average time
+// (1 is perfect balance; with p PEs it is at most p)
+inline double imbalance_ratio(const std::vector<double> &t)
+{
+    double tmax = 0.0, tsum = 0.0;
+    size_t p;
+    for (p = 0; p < t.size(); p++)
+    {
+        tmax = std::max(tmax, t[p]);
+        tsum += t[p];
+    }
+    return (tsum > 0.0) ? tmax * t.size() / tsum : 1.0;
+}
+
+#endif
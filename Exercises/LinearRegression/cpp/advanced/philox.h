@@ -0,0 +1,85 @@
+/***
+ * File: philox.h
+ * Description: Philox4x32-10 counter-based random number generator
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 11:14:52 am
+ * Last Modified: Saturday, 17th October 2026, 11:14:55 am
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_PHILOX_H
+#define LINREG_PHILOX_H
+
+#include <cstdint>
+#include <cmath>
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11).
+// It has no state: the output is a fixed function of a 128-bit counter and a
+// 64-bit key, so any PE or thread can produce the random numbers of any point
+// without knowing what anybody else generated.
+struct Philox4x32
+{
+    uint32_t v[4];
+};
+
+inline Philox4x32 philox4x32_10(uint64_t counter_lo, uint64_t counter_hi, uint64_t key)
+{
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57; // round multipliers
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85; // Weyl key increments
+    uint32_t c0 = (uint32_t)counter_lo, c1 = (uint32_t)(counter_lo >> 32);
+    uint32_t c2 = (uint32_t)counter_hi, c3 = (uint32_t)(counter_hi >> 32);
+    uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+    uint64_t p0, p1;
+    int round;
+
+    for (round = 0; round < 10; round++)
+    {
+        p0 = (uint64_t)M0 * c0;
+        p1 = (uint64_t)M1 * c2;
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)p1;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)p0;
+        k0 += W0;
+        k1 += W1;
+    }
+    Philox4x32 out = {{c0, c1, c2, c3}};
+    return out;
+}
+
+// 53 random bits to a double in (0,1], safe to pass to log()
+inline double philox_uniform(uint32_t lo, uint32_t hi)
+{
+    uint64_t bits = ((uint64_t)hi << 32) | lo;
+    return double((bits >> 11) + 1) * (1.0 / 9007199254740992.0); // 2^-53
+}
+
+// Two independent standard normal numbers for counter value index.
+// One Philox call gives the two uniforms, and both Box-Muller outputs are used.
+inline void philox_gaussian_pair(uint64_t index, uint64_t seed, double &z0, double &z1)
+{
+    const double twopi = 8.0 * atan(1.0);
+    Philox4x32 r = philox4x32_10(index, 0, seed);
+    double rad = sqrt(-2.0 * log(philox_uniform(r.v[0], r.v[1])));
+    double theta = twopi * philox_uniform(r.v[2], r.v[3]);
+    z0 = rad * cos(theta);
+    z1 = rad * sin(theta);
+}
+
+#endif
@@ -0,0 +1,190 @@
+/***
+ * File: pipeline.h
+ * Description: Double-buffered out-of-core pipeline: a background thread loads chunks while the kernels run
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 11:02:36 pm
+ * Last Modified: Saturday, 17th October 2026, 11:02:38 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_PIPELINE_H
+#define LINREG_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include "dataset.h"
+#include "dataset_io.h"
+#include "rss_kernel.h"
+
+// What the out-of-core pipeline spent its time on, on one PE. Kept in one
+// contiguous block of doubles so a single reduction combines them.
+struct PipelineStats
+{
+    double tio;      // I/O thread: reading or generating chunks
+    double tcompute; // compute threads: RSS kernels
+    double tstall;   // compute threads: waiting for the next chunk
+    double twall;    // start of the first chunk to end of the last one
+    double chunks;   // chunks processed
+};
+const int PIPELINE_STATS_LEN = 5;
+
+// Read count doubles at offset of fd, however many pread calls it takes
+inline bool pread_all(int fd, double *buf, long long count, off_t offset)
+{
+    char *p = (char *)buf;
+    long long left = count * (long long)sizeof(double);
+    ssize_t got;
+    while (left > 0)
+    {
+        got = pread(fd, p, left, offset);
+        if (got <= 0)
+        {
+            return false;
+        }
+        p += got;
+        offset += got;
+        left -= got;
+    }
+    return true;
+}
+
+// RSS of ncand candidates over the PE's points data.start..data.stop-1,
+// without ever holding more than depth chunks of chunk points. A background
+// thread fills a ring of depth buffers in order, from the dataset file path
+// (with pread, never through MPI, so MPI_THREAD_FUNNELED is enough) or from
+// the generator when path is empty. Meanwhile the calling thread and its
+// nthreads OpenMP threads run rss_candidates on the oldest full buffer. With
+// depth 2 this is double buffering: chunk k+1 is loaded while chunk k is
+// evaluated, and the wall time approaches the larger of the load and compute
+// times instead of their sum. rss[c] is overwritten; st is added to.
+// Returns false if a chunk could not be read.
+inline bool pipeline_rss_candidates(rss_fn kernel, const Dataset &data, const std::string &path, long long nfile,
+                                    const double *as, const double *bs, int ncand, long long chunk, int depth,
+                                    size_t block, double *rss, int nthreads, PipelineStats &st)
+{
+    struct Slot
+    {
+        std::vector<double> x, y;
+        long long len;
+        bool full, ok;
+    };
+    typedef std::chrono::steady_clock clk;
+    std::vector<Slot> ring(depth);
+    std::vector<double> part(ncand);
+    std::mutex mtx;
+    std::condition_variable cv;
+    long long k, nchunks = (data.size() + chunk - 1) / chunk;
+    clk::time_point t0, twall = clk::now();
+    bool ok = true;
+    int c, fd = -1;
+
+    for (c = 0; c < ncand; c++)
+    {
+        rss[c] = 0.0;
+    }
+    for (k = 0; k < depth; k++)
+    {
+        ring[k].x.resize(chunk);
+        ring[k].y.resize(chunk);
+        ring[k].full = false;
+    }
+    if (!path.empty())
+    {
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+    }
+
+    // the I/O thread: wait for the slot of chunk k to be free, then fill it
+    std::thread io([&]() {
+        long long j, first, last;
+        clk::time_point t;
+        for (j = 0; j < nchunks; j++)
+        {
+            Slot &s = ring[j % depth];
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&s]() { return !s.full; });
+            }
+            t = clk::now();
+            first = data.start + j * chunk;
+            last = std::min(first + chunk, data.stop);
+            s.len = last - first;
+            if (fd >= 0)
+            {
+                s.ok = pread_all(fd, s.x.data(), s.len, x_offset(first)) &&
+                       pread_all(fd, s.y.data(), s.len, y_offset(nfile, first));
+            }
+            else
+            {
+                generate_slice(first, last, data.dx, data.at, data.bt, data.seed, s.x.data(), s.y.data(), 1);
+                s.ok = true;
+            }
+            st.tio += std::chrono::duration<double>(clk::now() - t).count();
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                s.full = true;
+            }
+            cv.notify_all();
+        }
+    });
+
+    // the compute side: take the chunks in order and hand the slot back
+    for (k = 0; k < nchunks; k++)
+    {
+        Slot &s = ring[k % depth];
+        t0 = clk::now();
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&s]() { return s.full; });
+        }
+        st.tstall += std::chrono::duration<double>(clk::now() - t0).count();
+        t0 = clk::now();
+        ok = ok && s.ok;
+        rss_candidates(kernel, s.x.data(), s.y.data(), s.len, as, bs, ncand, block, part.data(), nthreads);
+        for (c = 0; c < ncand; c++)
+        {
+            rss[c] += part[c];
+        }
+        st.tcompute += std::chrono::duration<double>(clk::now() - t0).count();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            s.full = false;
+        }
+        cv.notify_all();
+    }
+    io.join();
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    st.twall += std::chrono::duration<double>(clk::now() - twall).count();
+    st.chunks += nchunks;
+    return ok;
+}
+
+#endif
@@ -0,0 +1,201 @@
+/***
+ * File: poly_kernel.h
+ * Description: Residual sum of squares kernels for polynomials of a fixed degree
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 10:02:18 pm
+ * Last Modified: Saturday, 17th October 2026, 10:02:20 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_POLY_KERNEL_H
+#define LINREG_POLY_KERNEL_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LINREG_X86 1
+#endif
+
+// A polynomial of degree D has D+1 coefficients, c[0] + c[1]*x + ... + c[D]*x^D.
+// Horner's rule evaluates it with D multiply-adds; the recursion is resolved
+// at compile time, so every degree gets a straight-line loop body the
+// compiler can vectorize.
+template <int D>
+struct Horner
+{
+    static const int NPAR = D + 1;
+    static inline double eval(const double *c, double x)
+    {
+        return Horner<D - 1>::eval(c + 1, x) * x + c[0];
+    }
+};
+
+template <>
+struct Horner<0>
+{
+    static const int NPAR = 1;
+    static inline double eval(const double *c, double /* x */)
+    {
+        return c[0];
+    }
+};
+
+// Every kernel returns sum_k (p(x[k]) - y[k])^2 over len points, for the
+// coefficients c of one candidate
+typedef double (*rss_poly_fn)(const double *x, const double *y, size_t len, const double *c);
+
+// The loop all kernels share. The coefficients are copied to a local array so
+// they stay in registers, and "omp simd" vectorizes the loop for whatever
+// instruction set the caller was compiled for. The four quarters of the
+// points go to four accumulators so consecutive iterations do not wait on
+// each other's additions; the results only differ from the plain loop by
+// the order of the floating-point sums.
+template <int D>
+__attribute__((always_inline)) inline double rss_poly_body(const double *x, const double *y, size_t len, const double *c)
+{
+    double cc[D + 1], r0 = 0.0, r1 = 0.0, r2 = 0.0, r3 = 0.0, d0, d1, d2, d3;
+    size_t k, q = len / 4;
+    int p;
+    for (p = 0; p <= D; p++)
+    {
+        cc[p] = c[p];
+    }
+#pragma omp simd reduction(+ : r0, r1, r2, r3) private(d0, d1, d2, d3)
+    for (k = 0; k < q; k++)
+    {
+        d0 = Horner<D>::eval(cc, x[k]) - y[k];
+        d1 = Horner<D>::eval(cc, x[k + q]) - y[k + q];
+        d2 = Horner<D>::eval(cc, x[k + 2 * q]) - y[k + 2 * q];
+        d3 = Horner<D>::eval(cc, x[k + 3 * q]) - y[k + 3 * q];
+        r0 += d0 * d0;
+        r1 += d1 * d1;
+        r2 += d2 * d2;
+        r3 += d3 * d3;
+    }
+    for (k = 4 * q; k < len; k++)
+    {
+        d0 = Horner<D>::eval(cc, x[k]) - y[k];
+        r0 += d0 * d0;
+    }
+    return (r0 + r1) + (r2 + r3);
+}
+
+// Baseline build: SSE2 on x86, plain code elsewhere
+template <int D>
+double rss_poly_generic(const double *x, const double *y, size_t len, const double *c)
+{
+    return rss_poly_body<D>(x, y, len, c);
+}
+
+#ifdef LINREG_X86
+// The same loop compiled for wider vectors; Horner's multiply-adds become FMAs
+template <int D>
+__attribute__((target("avx2,fma"))) double rss_poly_avx2(const double *x, const double *y, size_t len, const double *c)
+{
+    return rss_poly_body<D>(x, y, len, c);
+}
+
+template <int D>
+__attribute__((target("avx512f"))) double rss_poly_avx512(const double *x, const double *y, size_t len, const double *c)
+{
+    return rss_poly_body<D>(x, y, len, c);
+}
+#endif
+
+// Pick the degree-D kernel by name; "auto" takes the widest one this CPU
+// supports. On return, name holds the kernel actually chosen.
+template <int D>
+rss_poly_fn select_rss_poly_kernel(std::string &name)
+{
+#ifdef LINREG_X86
+    __builtin_cpu_init();
+    if (name == "auto")
+    {
+        if (__builtin_cpu_supports("avx512f"))
+            name = "avx512";
+        else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            name = "avx2";
+        else
+            name = "sse2";
+    }
+    if (name == "avx512" && __builtin_cpu_supports("avx512f"))
+        return rss_poly_avx512<D>;
+    if (name == "avx2" && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return rss_poly_avx2<D>;
+    name = "sse2";
+#else
+    name = "scalar";
+#endif
+    return rss_poly_generic<D>;
+}
+
+// RSS of ncand candidates over len points; the coefficients of candidate c
+// are coef[c*(D+1)] .. coef[c*(D+1)+D]. Same cache blocking and thread
+// partial sums as rss_candidates: a block of x and y is loaded once and
+// scored against every candidate, and the partial sums are added in thread
+// order. rss[c] is overwritten. Must be called outside of a parallel region.
+template <int D>
+void rss_poly_candidates(rss_poly_fn kernel, const double *x, const double *y, size_t len,
+                         const double *coef, int ncand, size_t block, double *rss, int nthreads)
+{
+    std::vector<double> partial((size_t)nthreads * ncand, 0.0);
+    long long ib, nblocks;
+    int c, t;
+
+    if (block == 0)
+    {
+        block = (len + nthreads - 1) / nthreads; // one block per thread
+    }
+    if (block == 0)
+    {
+        block = 1;
+    }
+    nblocks = (len + block - 1) / block;
+
+#pragma omp parallel num_threads(nthreads) private(c)
+    {
+        double *mine = partial.data() + (size_t)omp_get_thread_num() * ncand;
+        size_t start, count;
+#pragma omp for schedule(static)
+        for (ib = 0; ib < nblocks; ib++)
+        {
+            start = ib * block;
+            count = std::min(block, len - start);
+            for (c = 0; c < ncand; c++)
+            {
+                mine[c] += kernel(x + start, y + start, count, coef + (size_t)c * (D + 1));
+            }
+        }
+    }
+
+    for (c = 0; c < ncand; c++)
+    {
+        rss[c] = 0.0;
+        for (t = 0; t < nthreads; t++)
+        {
+            rss[c] += partial[(size_t)t * ncand + c];
+        }
+    }
+}
+
+#endif
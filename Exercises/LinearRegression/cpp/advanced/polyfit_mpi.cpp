@@ -0,0 +1,323 @@
+/***
+ * File: polyfit_mpi.cpp
+ * Description: MPI-parallelized polynomial regression by grid search, specialized per degree
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 10:11:45 pm
+ * Last Modified: Saturday, 17th October 2026, 10:11:47 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+/****
+ ***    This is NOT part of the workshop exercise. It generalizes the
+ ***    batched mode of linreg_advanced_mpi.cpp from a*x + b to a
+ ***    polynomial of degree 0 to MAX_DEGREE. The search is the same
+ ***    grid search, over one axis per coefficient.
+ ****/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+#include <mpi.h>
+#include <omp.h>
+
+#include "dataset.h"
+#include "partition.h"
+#include "poly_kernel.h"
+
+using namespace std;
+
+const int MAX_DEGREE = 4;
+
+struct PolyOptions
+{
+    long long n = 1 << 24;    // number of "data" points
+    int degree = 2;           // degree of the polynomial; it has degree+1 coefficients
+    int np = 10;              // grid points per coefficient
+    double d = 0.1;           // grid spacing; coefficient k takes the values d, 2d, ..., np*d
+    vector<double> target;    // target coefficients, lowest degree first (default: all 0.5)
+    unsigned long long seed = 0;
+    int tile = 0;             // candidates per vector reduction (0: whole grid)
+    int block = 4096;         // data points per cache block (0: no blocking)
+    string kernel = "auto";   // auto | sse2 | avx2 | avx512
+    int threads = 0;          // OpenMP threads per PE (0: OMP_NUM_THREADS)
+    bool print = false;       // print the MSE of every candidate
+};
+
+void print_usage(const char *prog)
+{
+    cout << "Usage: " << prog << " [--key=value ...]\n"
+         << "  --n=<int>           number of data points\n"
+         << "  --degree=<int>      degree of the polynomial, 0 to " << MAX_DEGREE << "\n"
+         << "  --np=<int>          grid points per coefficient\n"
+         << "  --d=<double>        grid spacing of every coefficient\n"
+         << "  --target=<c0,c1,..> target coefficients, lowest degree first (default 0.5 each)\n"
+         << "  --seed=<int>        random number generator seed\n"
+         << "  --tile=<int>        candidates per reduction (0: whole grid)\n"
+         << "  --block=<int>       data points per cache block (0: no blocking)\n"
+         << "  --kernel=<string>   auto | sse2 | avx2 | avx512\n"
+         << "  --threads=<int>     OpenMP threads per PE (0: OMP_NUM_THREADS)\n"
+         << "  --print=<0|1>       print the MSE of every candidate" << endl;
+}
+
+// Parse --key=value pairs into opt. Returns false on anything it does not understand.
+bool parse_options(int argc, char *argv[], PolyOptions &opt)
+{
+    long long ncand;
+    char *p, *end;
+    int k;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || eq == string::npos)
+        {
+            return false;
+        }
+        string key = arg.substr(2, eq - 2);
+        string val = arg.substr(eq + 1);
+
+        if (key == "n")
+            opt.n = atoll(val.c_str());
+        else if (key == "degree")
+            opt.degree = atoi(val.c_str());
+        else if (key == "np")
+            opt.np = atoi(val.c_str());
+        else if (key == "d")
+            opt.d = atof(val.c_str());
+        else if (key == "target")
+        {
+            opt.target.clear();
+            p = &arg[eq + 1];
+            while (*p != '\0')
+            {
+                opt.target.push_back(strtod(p, &end));
+                if (end == p || (*end != ',' && *end != '\0'))
+                {
+                    return false;
+                }
+                p = (*end == ',') ? end + 1 : end;
+            }
+        }
+        else if (key == "seed")
+            opt.seed = strtoull(val.c_str(), NULL, 10);
+        else if (key == "tile")
+            opt.tile = atoi(val.c_str());
+        else if (key == "block")
+            opt.block = atoi(val.c_str());
+        else if (key == "kernel")
+            opt.kernel = val;
+        else if (key == "threads")
+            opt.threads = atoi(val.c_str());
+        else if (key == "print")
+            opt.print = (atoi(val.c_str()) != 0);
+        else
+            return false;
+    }
+    if (opt.n <= 0 || opt.degree < 0 || opt.degree > MAX_DEGREE || opt.np <= 0 ||
+        opt.tile < 0 || opt.block < 0 || opt.threads < 0)
+    {
+        return false;
+    }
+    if (opt.target.empty())
+    {
+        opt.target.assign(opt.degree + 1, 0.5);
+    }
+    if ((int)opt.target.size() != opt.degree + 1)
+    {
+        return false;
+    }
+    // candidates are counted with int, as are the MPI counts of RSS vectors
+    ncand = 1;
+    for (k = 0; k <= opt.degree; k++)
+    {
+        ncand = ncand * opt.np;
+        if (ncand > INT_MAX)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Coefficients of candidate c. The grid is flattened into one index, digit
+// k (base np) of which picks coefficient k; the highest degree varies
+// slowest, the same order as the nested (a,b) loops of the line engine.
+void candidate_coefs(const PolyOptions &opt, int c, double *coef)
+{
+    int k;
+    for (k = 0; k <= opt.degree; k++)
+    {
+        coef[k] = (c % opt.np + 1) * opt.d;
+        c = c / opt.np;
+    }
+}
+
+// 3. Score every candidate on this PE's points, a tile at a time, and
+// combine each tile with a single vector reduction on PE 0. Returns the
+// time this PE spent in the search.
+template <int D>
+double search_poly(const PolyOptions &opt, const vector<double> &x, const vector<double> &y,
+                   string &kernelname, int myrank, vector<double> &mse)
+{
+    rss_poly_fn kernel = select_rss_poly_kernel<D>(kernelname);
+    vector<double> coef, myrss, worldrss;
+    int c, ncand, tile, first, count;
+    double t;
+
+    ncand = 1;
+    for (c = 0; c <= D; c++)
+    {
+        ncand = ncand * opt.np;
+    }
+    tile = (opt.tile > 0 && opt.tile < ncand) ? opt.tile : ncand;
+    coef.resize((size_t)tile * Horner<D>::NPAR);
+    myrss.resize(tile);
+    worldrss.resize(tile);
+    if (myrank == 0)
+    {
+        mse.reserve(ncand);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    for (first = 0; first < ncand; first += tile)
+    {
+        count = min(tile, ncand - first);
+        for (c = 0; c < count; c++)
+        {
+            candidate_coefs(opt, first + c, coef.data() + (size_t)c * Horner<D>::NPAR);
+        }
+        rss_poly_candidates<D>(kernel, x.data(), y.data(), x.size(), coef.data(), count,
+                               opt.block, myrss.data(), opt.threads);
+        MPI_Reduce(myrss.data(), worldrss.data(), count, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (myrank == 0)
+        {
+            for (c = 0; c < count; c++)
+            {
+                mse.push_back(worldrss[c] / double(opt.n));
+            }
+        }
+    }
+    return MPI_Wtime() - t;
+}
+
+// The degree is a template parameter of the kernels; pick the instance for
+// the degree asked for at run time
+double search(const PolyOptions &opt, const vector<double> &x, const vector<double> &y,
+              string &kernelname, int myrank, vector<double> &mse)
+{
+    switch (opt.degree)
+    {
+    case 0:
+        return search_poly<0>(opt, x, y, kernelname, myrank, mse);
+    case 1:
+        return search_poly<1>(opt, x, y, kernelname, myrank, mse);
+    case 2:
+        return search_poly<2>(opt, x, y, kernelname, myrank, mse);
+    case 3:
+        return search_poly<3>(opt, x, y, kernelname, myrank, mse);
+    default:
+        return search_poly<MAX_DEGREE>(opt, x, y, kernelname, myrank, mse);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    PolyOptions opt;
+    vector<double> x, y;   // this PE's points
+    vector<double> mse;    // mean squared error of each candidate
+    vector<double> coef;   // coefficients of one candidate
+    int c, k, best;
+    double tsearch, tmax;
+
+    // MPI variables
+    int myrank, nranks, mpierr, provided;
+    long long mystart, mystop;
+
+    mpierr = MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    mpierr = MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    mpierr = MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+
+    // 0. Read options; everybody parses the same command line
+    if (!parse_options(argc, argv, opt))
+    {
+        if (myrank == 0)
+        {
+            print_usage(argv[0]);
+        }
+        mpierr = MPI_Finalize();
+        return 1;
+    }
+    if (opt.threads == 0)
+    {
+        opt.threads = omp_get_max_threads();
+    }
+
+    // 1. Each PE generates its block of the points, the same decomposition
+    // as the line engine
+    balanced_range(opt.n, nranks, myrank, mystart, mystop);
+    x.resize(mystop - mystart);
+    y.resize(mystop - mystart);
+    generate_poly_slice(mystart, mystop, 1.0 / double(opt.n), opt.target, opt.seed, x.data(), y.data(), opt.threads);
+
+    // 2-3. Build the grid and score it
+    tsearch = search(opt, x, y, opt.kernel, myrank, mse);
+    mpierr = MPI_Reduce(&tsearch, &tmax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // 4. Look for the best candidate; ties go to the first one
+    if (myrank == 0)
+    {
+        coef.resize(opt.degree + 1);
+        best = 0;
+        for (c = 0; c < (int)mse.size(); c++)
+        {
+            if (mse[c] < mse[best])
+            {
+                best = c;
+            }
+            if (opt.print)
+            {
+                candidate_coefs(opt, c, coef.data());
+                cout << "c = (";
+                for (k = 0; k <= opt.degree; k++)
+                {
+                    cout << (k ? "," : "") << coef[k];
+                }
+                cout << ")      MSE = " << mse[c] << endl;
+            }
+        }
+        cout << "Search time (degree " << opt.degree << ", " << opt.kernel << " kernel): " << tmax << " s (slowest PE), ";
+        cout << 1.0e6 * tmax / mse.size() << " us per candidate" << endl;
+        candidate_coefs(opt, best, coef.data());
+        cout << "\n\nBest fit is for c = (";
+        for (k = 0; k <= opt.degree; k++)
+        {
+            cout << (k ? "," : "") << coef[k];
+        }
+        cout << ") with MSE = " << mse[best] << endl;
+    }
+
+    mpierr = MPI_Finalize();
+    return 0;
+}
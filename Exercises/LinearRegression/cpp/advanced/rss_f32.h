@@ -0,0 +1,313 @@
+/***
+ * File: rss_f32.h
+ * Description: RSS kernels for single-precision data with double-precision accumulation
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 5:12:40 pm
+ * Last Modified: Saturday, 17th October 2026, 5:12:44 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_RSS_F32_H
+#define LINREG_RSS_F32_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+#include "rss_kernel.h"
+
+// Kernels for --precision=float (x and y stored as float) and
+// --precision=implicit (only y is stored; x0 + k*dx is recomputed). They
+// read 8 or 4 bytes per point instead of 16, and the vector versions work on
+// twice as many lanes as their double counterparts. Residuals and squares are
+// computed in float, summed in float over segments of F32_SEGMENT points
+// only, and every segment sum is added to double accumulators, so rounding
+// errors do not grow with the size of the dataset.
+// Both layouts share one signature: float kernels ignore x0 and dx,
+// implicit kernels ignore x. Point k of the call has x = x0 + k*dx.
+typedef double (*rss_f32_fn)(const float *x, double x0, double dx, const float *y, size_t len, double as, double bs);
+
+const size_t F32_SEGMENT = 1024;
+
+// Portable versions: plain double arithmetic on the float data, 4 accumulators
+inline double rss_f32_scalar(const float *x, double /* x0 */, double /* dx */, const float *y, size_t len, double as, double bs)
+{
+    double r0 = 0.0, r1 = 0.0, r2 = 0.0, r3 = 0.0;
+    double d0, d1, d2, d3;
+    size_t k = 0;
+    for (; k + 4 <= len; k += 4)
+    {
+        d0 = as * x[k] + bs - y[k];
+        d1 = as * x[k + 1] + bs - y[k + 1];
+        d2 = as * x[k + 2] + bs - y[k + 2];
+        d3 = as * x[k + 3] + bs - y[k + 3];
+        r0 += d0 * d0;
+        r1 += d1 * d1;
+        r2 += d2 * d2;
+        r3 += d3 * d3;
+    }
+    for (; k < len; k++)
+    {
+        d0 = as * x[k] + bs - y[k];
+        r0 += d0 * d0;
+    }
+    return (r0 + r1) + (r2 + r3);
+}
+
+// The fitted value moves by as*dx from one point to the next
+inline double rss_implicit_scalar(const float * /* x */, double x0, double dx, const float *y, size_t len, double as, double bs)
+{
+    double r0 = 0.0, r1 = 0.0, r2 = 0.0, r3 = 0.0;
+    double d0, d1, d2, d3, fit, step = as * dx;
+    size_t k = 0;
+    for (; k + 4 <= len; k += 4)
+    {
+        fit = as * (x0 + k * dx) + bs;
+        d0 = fit - y[k];
+        d1 = fit + step - y[k + 1];
+        d2 = fit + 2.0 * step - y[k + 2];
+        d3 = fit + 3.0 * step - y[k + 3];
+        r0 += d0 * d0;
+        r1 += d1 * d1;
+        r2 += d2 * d2;
+        r3 += d3 * d3;
+    }
+    for (; k < len; k++)
+    {
+        d0 = as * (x0 + k * dx) + bs - y[k];
+        r0 += d0 * d0;
+    }
+    return (r0 + r1) + (r2 + r3);
+}
+
+#ifdef LINREG_X86
+// AVX2 + FMA: 8 lanes x 4 accumulators
+__attribute__((target("avx2,fma"))) inline double rss_f32_avx2(const float *x, double /* x0 */, double /* dx */, const float *y, size_t len, double as, double bs)
+{
+    __m256 va = _mm256_set1_ps((float)as), vb = _mm256_set1_ps((float)bs);
+    __m256 r0, r1, r2, r3, d0, d1, d2, d3;
+    __m256d acc = _mm256_setzero_pd();
+    double out[4];
+    size_t k = 0, stop;
+    while (k + 32 <= len)
+    {
+        stop = k + std::min(len - k, F32_SEGMENT) / 32 * 32;
+        r0 = r1 = r2 = r3 = _mm256_setzero_ps();
+        for (; k < stop; k += 32)
+        {
+            d0 = _mm256_sub_ps(_mm256_fmadd_ps(va, _mm256_loadu_ps(x + k), vb), _mm256_loadu_ps(y + k));
+            d1 = _mm256_sub_ps(_mm256_fmadd_ps(va, _mm256_loadu_ps(x + k + 8), vb), _mm256_loadu_ps(y + k + 8));
+            d2 = _mm256_sub_ps(_mm256_fmadd_ps(va, _mm256_loadu_ps(x + k + 16), vb), _mm256_loadu_ps(y + k + 16));
+            d3 = _mm256_sub_ps(_mm256_fmadd_ps(va, _mm256_loadu_ps(x + k + 24), vb), _mm256_loadu_ps(y + k + 24));
+            r0 = _mm256_fmadd_ps(d0, d0, r0);
+            r1 = _mm256_fmadd_ps(d1, d1, r1);
+            r2 = _mm256_fmadd_ps(d2, d2, r2);
+            r3 = _mm256_fmadd_ps(d3, d3, r3);
+        }
+        r0 = _mm256_add_ps(_mm256_add_ps(r0, r1), _mm256_add_ps(r2, r3));
+        acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(r0)));
+        acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(r0, 1)));
+    }
+    _mm256_storeu_pd(out, acc);
+    return (out[0] + out[1]) + (out[2] + out[3]) + rss_f32_scalar(x + k, 0.0, 0.0, y + k, len - k, as, bs);
+}
+
+// Within a segment starting at point k, x = x(k) + j*dx for j < F32_SEGMENT,
+// so the fitted line is alpha*j + beta with j exact in float
+__attribute__((target("avx2,fma"))) inline double rss_implicit_avx2(const float *x, double x0, double dx, const float *y, size_t len, double as, double bs)
+{
+    __m256 valpha = _mm256_set1_ps((float)(as * dx)), vbeta;
+    __m256 vj, v8 = _mm256_set1_ps(8.0f);
+    __m256 r0, r1, r2, r3, d0, d1, d2, d3;
+    __m256d acc = _mm256_setzero_pd();
+    double out[4];
+    size_t k = 0, stop;
+    while (k + 32 <= len)
+    {
+        stop = k + std::min(len - k, F32_SEGMENT) / 32 * 32;
+        vbeta = _mm256_set1_ps((float)(as * (x0 + k * dx) + bs));
+        vj = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+        r0 = r1 = r2 = r3 = _mm256_setzero_ps();
+        for (; k < stop; k += 32)
+        {
+            d0 = _mm256_sub_ps(_mm256_fmadd_ps(valpha, vj, vbeta), _mm256_loadu_ps(y + k));
+            vj = _mm256_add_ps(vj, v8);
+            d1 = _mm256_sub_ps(_mm256_fmadd_ps(valpha, vj, vbeta), _mm256_loadu_ps(y + k + 8));
+            vj = _mm256_add_ps(vj, v8);
+            d2 = _mm256_sub_ps(_mm256_fmadd_ps(valpha, vj, vbeta), _mm256_loadu_ps(y + k + 16));
+            vj = _mm256_add_ps(vj, v8);
+            d3 = _mm256_sub_ps(_mm256_fmadd_ps(valpha, vj, vbeta), _mm256_loadu_ps(y + k + 24));
+            vj = _mm256_add_ps(vj, v8);
+            r0 = _mm256_fmadd_ps(d0, d0, r0);
+            r1 = _mm256_fmadd_ps(d1, d1, r1);
+            r2 = _mm256_fmadd_ps(d2, d2, r2);
+            r3 = _mm256_fmadd_ps(d3, d3, r3);
+        }
+        r0 = _mm256_add_ps(_mm256_add_ps(r0, r1), _mm256_add_ps(r2, r3));
+        acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(r0)));
+        acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(r0, 1)));
+    }
+    _mm256_storeu_pd(out, acc);
+    return (out[0] + out[1]) + (out[2] + out[3]) + rss_implicit_scalar(x, x0 + k * dx, dx, y + k, len - k, as, bs);
+}
+
+// AVX-512: 16 lanes x 4 accumulators
+__attribute__((target("avx512f"))) inline double rss_f32_avx512(const float *x, double /* x0 */, double /* dx */, const float *y, size_t len, double as, double bs)
+{
+    __m512 va = _mm512_set1_ps((float)as), vb = _mm512_set1_ps((float)bs);
+    __m512 r0, r1, r2, r3, d0, d1, d2, d3;
+    __m512d acc = _mm512_setzero_pd();
+    size_t k = 0, stop;
+    while (k + 64 <= len)
+    {
+        stop = k + std::min(len - k, F32_SEGMENT) / 64 * 64;
+        r0 = r1 = r2 = r3 = _mm512_setzero_ps();
+        for (; k < stop; k += 64)
+        {
+            d0 = _mm512_sub_ps(_mm512_fmadd_ps(va, _mm512_loadu_ps(x + k), vb), _mm512_loadu_ps(y + k));
+            d1 = _mm512_sub_ps(_mm512_fmadd_ps(va, _mm512_loadu_ps(x + k + 16), vb), _mm512_loadu_ps(y + k + 16));
+            d2 = _mm512_sub_ps(_mm512_fmadd_ps(va, _mm512_loadu_ps(x + k + 32), vb), _mm512_loadu_ps(y + k + 32));
+            d3 = _mm512_sub_ps(_mm512_fmadd_ps(va, _mm512_loadu_ps(x + k + 48), vb), _mm512_loadu_ps(y + k + 48));
+            r0 = _mm512_fmadd_ps(d0, d0, r0);
+            r1 = _mm512_fmadd_ps(d1, d1, r1);
+            r2 = _mm512_fmadd_ps(d2, d2, r2);
+            r3 = _mm512_fmadd_ps(d3, d3, r3);
+        }
+        r0 = _mm512_add_ps(_mm512_add_ps(r0, r1), _mm512_add_ps(r2, r3));
+        acc = _mm512_add_pd(acc, _mm512_cvtps_pd(_mm512_castps512_ps256(r0)));
+        acc = _mm512_add_pd(acc, _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(r0), 1))));
+    }
+    return _mm512_reduce_add_pd(acc) + rss_f32_scalar(x + k, 0.0, 0.0, y + k, len - k, as, bs);
+}
+
+__attribute__((target("avx512f"))) inline double rss_implicit_avx512(const float *x, double x0, double dx, const float *y, size_t len, double as, double bs)
+{
+    __m512 valpha = _mm512_set1_ps((float)(as * dx)), vbeta;
+    __m512 vj, v16 = _mm512_set1_ps(16.0f);
+    __m512 r0, r1, r2, r3, d0, d1, d2, d3;
+    __m512d acc = _mm512_setzero_pd();
+    size_t k = 0, stop;
+    while (k + 64 <= len)
+    {
+        stop = k + std::min(len - k, F32_SEGMENT) / 64 * 64;
+        vbeta = _mm512_set1_ps((float)(as * (x0 + k * dx) + bs));
+        vj = _mm512_set_ps(15.0f, 14.0f, 13.0f, 12.0f, 11.0f, 10.0f, 9.0f, 8.0f,
+                           7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+        r0 = r1 = r2 = r3 = _mm512_setzero_ps();
+        for (; k < stop; k += 64)
+        {
+            d0 = _mm512_sub_ps(_mm512_fmadd_ps(valpha, vj, vbeta), _mm512_loadu_ps(y + k));
+            vj = _mm512_add_ps(vj, v16);
+            d1 = _mm512_sub_ps(_mm512_fmadd_ps(valpha, vj, vbeta), _mm512_loadu_ps(y + k + 16));
+            vj = _mm512_add_ps(vj, v16);
+            d2 = _mm512_sub_ps(_mm512_fmadd_ps(valpha, vj, vbeta), _mm512_loadu_ps(y + k + 32));
+            vj = _mm512_add_ps(vj, v16);
+            d3 = _mm512_sub_ps(_mm512_fmadd_ps(valpha, vj, vbeta), _mm512_loadu_ps(y + k + 48));
+            vj = _mm512_add_ps(vj, v16);
+            r0 = _mm512_fmadd_ps(d0, d0, r0);
+            r1 = _mm512_fmadd_ps(d1, d1, r1);
+            r2 = _mm512_fmadd_ps(d2, d2, r2);
+            r3 = _mm512_fmadd_ps(d3, d3, r3);
+        }
+        r0 = _mm512_add_ps(_mm512_add_ps(r0, r1), _mm512_add_ps(r2, r3));
+        acc = _mm512_add_pd(acc, _mm512_cvtps_pd(_mm512_castps512_ps256(r0)));
+        acc = _mm512_add_pd(acc, _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(r0), 1))));
+    }
+    return _mm512_reduce_add_pd(acc) + rss_implicit_scalar(x, x0 + k * dx, dx, y + k, len - k, as, bs);
+}
+#endif
+
+// Same choice as select_rss_kernel, for the float or implicit layout. There
+// are no SSE2 versions; name is left as the kernel actually chosen.
+inline rss_f32_fn select_rss_f32_kernel(std::string &name, bool implicit)
+{
+#ifdef LINREG_X86
+    __builtin_cpu_init();
+    if (name == "auto")
+    {
+        if (__builtin_cpu_supports("avx512f"))
+            name = "avx512";
+        else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            name = "avx2";
+    }
+    if (name == "avx512" && __builtin_cpu_supports("avx512f"))
+        return implicit ? rss_implicit_avx512 : rss_f32_avx512;
+    if (name == "avx2" && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return implicit ? rss_implicit_avx2 : rss_f32_avx2;
+#endif
+    name = "scalar";
+    return implicit ? rss_implicit_scalar : rss_f32_scalar;
+}
+
+// rss_candidates for single-precision data; x is null with the implicit
+// layout, and point k of the slice has x = x0 + k*dx. The per-block results
+// are added with Kahan summation, so the running totals of each thread keep
+// the accuracy of the segment sums.
+inline void rss_candidates_f32(rss_f32_fn kernel, const float *x, double x0, double dx, const float *y, size_t len,
+                               const double *as, const double *bs, int ncand,
+                               size_t block, double *rss, int nthreads)
+{
+    std::vector<double> partial((size_t)nthreads * ncand, 0.0);
+    std::vector<double> carry((size_t)nthreads * ncand, 0.0);
+    long long ib, nblocks;
+    int c, t;
+
+    if (block == 0)
+    {
+        block = (len + nthreads - 1) / nthreads; // one block per thread
+    }
+    if (block == 0)
+    {
+        block = 1;
+    }
+    nblocks = (len + block - 1) / block;
+
+#pragma omp parallel num_threads(nthreads) private(c)
+    {
+        double *mine = partial.data() + (size_t)omp_get_thread_num() * ncand;
+        double *comp = carry.data() + (size_t)omp_get_thread_num() * ncand;
+        double r, sum;
+        size_t start, count;
+#pragma omp for schedule(static)
+        for (ib = 0; ib < nblocks; ib++)
+        {
+            start = ib * block;
+            count = std::min(block, len - start);
+            for (c = 0; c < ncand; c++)
+            {
+                r = kernel(x == nullptr ? nullptr : x + start, x0 + start * dx, dx, y + start, count, as[c], bs[c]) - comp[c];
+                sum = mine[c] + r;
+                comp[c] = (sum - mine[c]) - r;
+                mine[c] = sum;
+            }
+        }
+    }
+
+    for (c = 0; c < ncand; c++)
+    {
+        rss[c] = 0.0;
+        for (t = 0; t < nthreads; t++)
+        {
+            rss[c] += partial[(size_t)t * ncand + c];
+        }
+    }
+}
+
+#endif
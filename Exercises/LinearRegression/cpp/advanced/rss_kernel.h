@@ -0,0 +1,247 @@
+/***
+ * File: rss_kernel.h
+ * Description: Vectorized, cache-blocked residual sum of squares kernels
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 10:05:37 am
+ * Last Modified: Saturday, 17th October 2026, 10:05:40 am
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_RSS_KERNEL_H
+#define LINREG_RSS_KERNEL_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <mpi.h>
+#include <omp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LINREG_X86 1
+#include <immintrin.h>
+#endif
+
+// Every kernel returns sum_k (as*x[k] + bs - y[k])^2 over len points.
+// They keep several independent accumulators so consecutive iterations do
+// not wait on each other's additions, and the results only differ from the
+// plain loop by the order of the floating-point sums.
+typedef double (*rss_fn)(const double *x, const double *y, size_t len, double as, double bs);
+
+// Portable version: 4 scalar accumulators
+inline double rss_scalar(const double *x, const double *y, size_t len, double as, double bs)
+{
+    double r0 = 0.0, r1 = 0.0, r2 = 0.0, r3 = 0.0;
+    double d0, d1, d2, d3;
+    size_t k = 0;
+    for (; k + 4 <= len; k += 4)
+    {
+        d0 = as * x[k] + bs - y[k];
+        d1 = as * x[k + 1] + bs - y[k + 1];
+        d2 = as * x[k + 2] + bs - y[k + 2];
+        d3 = as * x[k + 3] + bs - y[k + 3];
+        r0 += d0 * d0;
+        r1 += d1 * d1;
+        r2 += d2 * d2;
+        r3 += d3 * d3;
+    }
+    for (; k < len; k++)
+    {
+        d0 = as * x[k] + bs - y[k];
+        r0 += d0 * d0;
+    }
+    return (r0 + r1) + (r2 + r3);
+}
+
+#ifdef LINREG_X86
+// SSE2: 2 lanes x 4 accumulators
+__attribute__((target("sse2"))) inline double rss_sse2(const double *x, const double *y, size_t len, double as, double bs)
+{
+    __m128d va = _mm_set1_pd(as), vb = _mm_set1_pd(bs);
+    __m128d r0 = _mm_setzero_pd(), r1 = _mm_setzero_pd(), r2 = _mm_setzero_pd(), r3 = _mm_setzero_pd();
+    __m128d d0, d1, d2, d3;
+    double out[2];
+    size_t k = 0;
+    for (; k + 8 <= len; k += 8)
+    {
+        d0 = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + k)), vb), _mm_loadu_pd(y + k));
+        d1 = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + k + 2)), vb), _mm_loadu_pd(y + k + 2));
+        d2 = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + k + 4)), vb), _mm_loadu_pd(y + k + 4));
+        d3 = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + k + 6)), vb), _mm_loadu_pd(y + k + 6));
+        r0 = _mm_add_pd(r0, _mm_mul_pd(d0, d0));
+        r1 = _mm_add_pd(r1, _mm_mul_pd(d1, d1));
+        r2 = _mm_add_pd(r2, _mm_mul_pd(d2, d2));
+        r3 = _mm_add_pd(r3, _mm_mul_pd(d3, d3));
+    }
+    _mm_storeu_pd(out, _mm_add_pd(_mm_add_pd(r0, r1), _mm_add_pd(r2, r3)));
+    return out[0] + out[1] + rss_scalar(x + k, y + k, len - k, as, bs);
+}
+
+// AVX2 + FMA: 4 lanes x 4 accumulators
+__attribute__((target("avx2,fma"))) inline double rss_avx2(const double *x, const double *y, size_t len, double as, double bs)
+{
+    __m256d va = _mm256_set1_pd(as), vb = _mm256_set1_pd(bs);
+    __m256d r0 = _mm256_setzero_pd(), r1 = _mm256_setzero_pd(), r2 = _mm256_setzero_pd(), r3 = _mm256_setzero_pd();
+    __m256d d0, d1, d2, d3;
+    double out[4];
+    size_t k = 0;
+    for (; k + 16 <= len; k += 16)
+    {
+        d0 = _mm256_sub_pd(_mm256_fmadd_pd(va, _mm256_loadu_pd(x + k), vb), _mm256_loadu_pd(y + k));
+        d1 = _mm256_sub_pd(_mm256_fmadd_pd(va, _mm256_loadu_pd(x + k + 4), vb), _mm256_loadu_pd(y + k + 4));
+        d2 = _mm256_sub_pd(_mm256_fmadd_pd(va, _mm256_loadu_pd(x + k + 8), vb), _mm256_loadu_pd(y + k + 8));
+        d3 = _mm256_sub_pd(_mm256_fmadd_pd(va, _mm256_loadu_pd(x + k + 12), vb), _mm256_loadu_pd(y + k + 12));
+        r0 = _mm256_fmadd_pd(d0, d0, r0);
+        r1 = _mm256_fmadd_pd(d1, d1, r1);
+        r2 = _mm256_fmadd_pd(d2, d2, r2);
+        r3 = _mm256_fmadd_pd(d3, d3, r3);
+    }
+    _mm256_storeu_pd(out, _mm256_add_pd(_mm256_add_pd(r0, r1), _mm256_add_pd(r2, r3)));
+    return (out[0] + out[1]) + (out[2] + out[3]) + rss_scalar(x + k, y + k, len - k, as, bs);
+}
+
+// AVX-512: 8 lanes x 4 accumulators
+__attribute__((target("avx512f"))) inline double rss_avx512(const double *x, const double *y, size_t len, double as, double bs)
+{
+    __m512d va = _mm512_set1_pd(as), vb = _mm512_set1_pd(bs);
+    __m512d r0 = _mm512_setzero_pd(), r1 = _mm512_setzero_pd(), r2 = _mm512_setzero_pd(), r3 = _mm512_setzero_pd();
+    __m512d d0, d1, d2, d3;
+    size_t k = 0;
+    for (; k + 32 <= len; k += 32)
+    {
+        d0 = _mm512_sub_pd(_mm512_fmadd_pd(va, _mm512_loadu_pd(x + k), vb), _mm512_loadu_pd(y + k));
+        d1 = _mm512_sub_pd(_mm512_fmadd_pd(va, _mm512_loadu_pd(x + k + 8), vb), _mm512_loadu_pd(y + k + 8));
+        d2 = _mm512_sub_pd(_mm512_fmadd_pd(va, _mm512_loadu_pd(x + k + 16), vb), _mm512_loadu_pd(y + k + 16));
+        d3 = _mm512_sub_pd(_mm512_fmadd_pd(va, _mm512_loadu_pd(x + k + 24), vb), _mm512_loadu_pd(y + k + 24));
+        r0 = _mm512_fmadd_pd(d0, d0, r0);
+        r1 = _mm512_fmadd_pd(d1, d1, r1);
+        r2 = _mm512_fmadd_pd(d2, d2, r2);
+        r3 = _mm512_fmadd_pd(d3, d3, r3);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(r0, r1), _mm512_add_pd(r2, r3))) + rss_scalar(x + k, y + k, len - k, as, bs);
+}
+#endif
+
+// Pick a kernel by name; "auto" takes the widest one this CPU supports.
+// On return, name holds the kernel actually chosen.
+inline rss_fn select_rss_kernel(std::string &name)
+{
+#ifdef LINREG_X86
+    __builtin_cpu_init();
+    if (name == "auto")
+    {
+        if (__builtin_cpu_supports("avx512f"))
+            name = "avx512";
+        else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            name = "avx2";
+        else
+            name = "sse2";
+    }
+    if (name == "avx512" && __builtin_cpu_supports("avx512f"))
+        return rss_avx512;
+    if (name == "avx2" && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return rss_avx2;
+    if (name == "sse2")
+        return rss_sse2;
+#endif
+    name = "scalar";
+    return rss_scalar;
+}
+
+// RSS of ncand candidates over len points. The data is walked in blocks of
+// block points so that a block of x and y is loaded from memory once and
+// then served from cache to every candidate. Blocks are shared among
+// nthreads OpenMP threads; each thread keeps its own partial sums, which are
+// added in thread order so the result does not depend on scheduling.
+// rss[c] is overwritten. Must be called outside of a parallel region.
+inline void rss_candidates(rss_fn kernel, const double *x, const double *y, size_t len,
+                           const double *as, const double *bs, int ncand,
+                           size_t block, double *rss, int nthreads)
+{
+    std::vector<double> partial((size_t)nthreads * ncand, 0.0);
+    long long ib, nblocks;
+    int c, t;
+
+    if (block == 0)
+    {
+        block = (len + nthreads - 1) / nthreads; // one block per thread
+    }
+    if (block == 0)
+    {
+        block = 1;
+    }
+    nblocks = (len + block - 1) / block;
+
+#pragma omp parallel num_threads(nthreads) private(c)
+    {
+        double *mine = partial.data() + (size_t)omp_get_thread_num() * ncand;
+        size_t start, count;
+#pragma omp for schedule(static)
+        for (ib = 0; ib < nblocks; ib++)
+        {
+            start = ib * block;
+            count = std::min(block, len - start);
+            for (c = 0; c < ncand; c++)
+            {
+                mine[c] += kernel(x + start, y + start, count, as[c], bs[c]);
+            }
+        }
+    }
+
+    for (c = 0; c < ncand; c++)
+    {
+        rss[c] = 0.0;
+        for (t = 0; t < nthreads; t++)
+        {
+            rss[c] += partial[(size_t)t * ncand + c];
+        }
+    }
+}
+
+// Quick STREAM-triad estimate of the memory bandwidth available to one PE,
+// in GB/s. All PEs run it together so they compete for memory as they will
+// in the real RSS pass, each with nthreads threads. Arrays of len doubles
+// each, best of ntimes.
+inline double stream_triad_gbs(size_t len, int ntimes, int nthreads, MPI_Comm comm)
+{
+    std::vector<double> sa(len, 1.0), sb(len, 2.0), sc(len, 0.5);
+    double t, best = 1.0e30;
+    long long k;
+    int it;
+    for (it = 0; it < ntimes; it++)
+    {
+        MPI_Barrier(comm);
+        t = MPI_Wtime();
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+        for (k = 0; k < (long long)len; k++)
+        {
+            sa[k] = sb[k] + 3.0 * sc[k];
+        }
+        t = MPI_Wtime() - t;
+        best = std::min(best, t);
+    }
+    // keep the compiler from dropping the loop
+    if (sa[len / 2] < 0.0)
+    {
+        best = best + 1.0;
+    }
+    return 3.0 * sizeof(double) * len / best / 1.0e9;
+}
+
+#endif
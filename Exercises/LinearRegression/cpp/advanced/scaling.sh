@@ -0,0 +1,42 @@
+#!/bin/bash
+# Strong and weak scaling of the engine, from the phase timings it prints.
+# Strong scaling keeps n fixed; weak scaling gives every PE n points.
+# The 1-PE run of each sweep is the baseline, and speedup/efficiency are
+# computed on data + search + select (slowest PE of each phase); init is
+# mostly MPI start-up, which does not scale, so it is reported but left out.
+# Usage: ./scaling.sh [max PEs] [n] [extra engine options...]
+# Writes CSV to stdout:
+# scaling,pes,n,init_s,data_s,search_s,select_s,run_s,speedup,efficiency
+
+MAXNP=${1:-4}
+N=${2:-16777216}
+shift
+shift
+EXE=./linreg_advanced_mpi.exe
+OPTS="--na=40 --nb=40 --print=0 --reps=3 --mode=batched $*"
+
+echo "scaling,pes,n,init_s,data_s,search_s,select_s,run_s,speedup,efficiency"
+for SCALING in strong weak; do
+    T1=""
+    NP=1
+    while [ $NP -le $MAXNP ]; do
+        if [ $SCALING == strong ]; then
+            NPTS=$N
+        else
+            NPTS=$((N * NP))
+        fi
+        # max column of each phase line, in phase order
+        TIMES=$(mpirun -n $NP $EXE $OPTS --n=$NPTS | awk -F, '/^phase,(init|data|search|select),/ {printf "%s,", $5}')
+        RUN=$(echo $TIMES | awk -F, '{print $2 + $3 + $4}')
+        if [ -z "$T1" ]; then
+            T1=$RUN
+        fi
+        # weak scaling: ideal run time stays flat, so efficiency is T1/Tp
+        # and the scaled speedup is NP times that
+        echo "$SCALING,$NP,$NPTS,$TIMES$RUN" | awk -F, -v t1=$T1 -v np=$NP -v s=$SCALING '{
+            if (s == "strong") { sp = t1 / $8; ef = sp / np }
+            else { ef = t1 / $8; sp = np * ef }
+            printf "%s,%.4f,%.4f\n", $0, sp, ef }'
+        NP=$((NP * 2))
+    done
+done
@@ -0,0 +1,236 @@
+/***
+ * File: solver.h
+ * Description: Distributed gradient descent, Newton and mini-batch SGD for the straight line
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 10:38:52 pm
+ * Last Modified: Saturday, 17th October 2026, 10:38:54 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_SOLVER_H
+#define LINREG_SOLVER_H
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <mpi.h>
+#include "philox.h"
+
+// With the residual r = a*x + b - y, the MSE and its derivatives are
+//     MSE = Srr/n,  gradient = (2/n) (Srx, Sr),  Hessian = (2/n) [[Sxx, Sx], [Sx, n]]
+// so one pass over the local points and one reduction of these six sums
+// give everything an iteration needs, on every PE.
+struct GradSums
+{
+    double n;   // number of points (a double so the whole struct is one MPI_DOUBLE block)
+    double sx;  // sum of x
+    double sxx; // sum of x^2
+    double sr;  // sum of r
+    double srx; // sum of r*x
+    double srr; // sum of r^2
+};
+const int GRADSUMS_LEN = 6;
+
+// Add the sums of point (x, y) for the line (a, b)
+inline void add_point(GradSums &s, double x, double y, double a, double b)
+{
+    double r = a * x + b - y;
+    s.n += 1.0;
+    s.sx += x;
+    s.sxx += x * x;
+    s.sr += r;
+    s.srx += r * x;
+    s.srr += r * r;
+}
+
+// Sums over all len local points, with nthreads OpenMP threads
+inline GradSums local_grad_sums(const double *x, const double *y, size_t len, double a, double b, int nthreads)
+{
+    double sx = 0.0, sxx = 0.0, sr = 0.0, srx = 0.0, srr = 0.0, r;
+    long long k;
+#pragma omp parallel for num_threads(nthreads) schedule(static) private(r) reduction(+ : sx, sxx, sr, srx, srr)
+    for (k = 0; k < (long long)len; k++)
+    {
+        r = a * x[k] + b - y[k];
+        sx += x[k];
+        sxx += x[k] * x[k];
+        sr += r;
+        srx += r * x[k];
+        srr += r * r;
+    }
+    GradSums s = {double(len), sx, sxx, sr, srx, srr};
+    return s;
+}
+
+// Sums over batch points drawn uniformly (with replacement) from the len
+// local points. Philox counter (iter, rank) picks them, so every PE and
+// every iteration gets its own sample and a run can be repeated exactly.
+inline GradSums sample_grad_sums(const double *x, const double *y, size_t len, double a, double b,
+                                 int batch, long long iter, int rank, uint64_t seed)
+{
+    GradSums s = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    Philox4x32 r;
+    uint64_t k;
+    int m;
+    if (len == 0)
+    {
+        return s;
+    }
+    for (m = 0; m < batch; m += 2)
+    {
+        r = philox4x32_10(iter, ((uint64_t)rank << 32) | (uint64_t)m, seed + 1);
+        k = (((uint64_t)r.v[0] << 32) | r.v[1]) % len;
+        add_point(s, x[k], y[k], a, b);
+        if (m + 1 < batch)
+        {
+            k = (((uint64_t)r.v[2] << 32) | r.v[3]) % len;
+            add_point(s, x[k], y[k], a, b);
+        }
+    }
+    return s;
+}
+
+// Largest eigenvalue of the Hessian: 1/L is the longest step gradient
+// descent can take on a quadratic without diverging
+inline double hessian_lmax(const GradSums &s)
+{
+    double tr = 2.0 * (s.sxx + s.n) / s.n;
+    double det = 4.0 * (s.sxx * s.n - s.sx * s.sx) / (s.n * s.n);
+    return 0.5 * (tr + sqrt(std::max(tr * tr - 4.0 * det, 0.0)));
+}
+
+struct SolverResult
+{
+    double a, b; // fitted line
+    double mse;  // over all points
+    int iters;   // iterations, i.e. MPI_Allreduce calls, until convergence
+    bool converged;
+};
+
+// Iterates of mini-batch SGD averaged per window; the averages are what is
+// compared against the tolerance and what is returned
+const int SGD_WINDOW = 100;
+
+// Fit the line to the points of all PEs of comm, starting from (a, b).
+//   gd:     full-batch gradient descent with step 1/L
+//   newton: full-batch Newton steps (exact after one step, since the MSE is quadratic)
+//   sgd:    mini-batch SGD, batch points per PE, constant step 1/L of the batch. The
+//           iterates bounce around the solution with the sampling noise, so they are
+//           averaged over windows of SGD_WINDOW iterations, and the result is the
+//           last window's average, with any iterations after it folded in
+// Every iteration costs one pass over the local points (batch points for
+// sgd) and one MPI_Allreduce of GRADSUMS_LEN doubles. gd and newton stop
+// when a step moves (a, b) by less than tol, sgd when the averages of two
+// consecutive windows differ by less than tol (the noise of an average
+// puts a floor on it, so sgd needs a far looser tol); either way after
+// maxiter iterations at most. All PEs return the same result.
+inline SolverResult solve_line(const std::string &method, const double *x, const double *y, size_t len,
+                               double a, double b, int maxiter, double tol, int batch, uint64_t seed,
+                               int nthreads, MPI_Comm comm)
+{
+    GradSums mine, s;
+    SolverResult res;
+    double ga, gb, da, db, haa, hab, hbb, det, step, suma = 0.0, sumb = 0.0, avga = a, avgb = b;
+    int iter, rank, full, rest;
+
+    MPI_Comm_rank(comm, &rank);
+    res.converged = false;
+    for (iter = 1; iter <= maxiter; iter++)
+    {
+        if (method == "sgd")
+        {
+            mine = sample_grad_sums(x, y, len, a, b, batch, iter, rank, seed);
+        }
+        else
+        {
+            mine = local_grad_sums(x, y, len, a, b, nthreads);
+        }
+        MPI_Allreduce(&mine.n, &s.n, GRADSUMS_LEN, MPI_DOUBLE, MPI_SUM, comm);
+
+        ga = 2.0 * s.srx / s.n;
+        gb = 2.0 * s.sr / s.n;
+        if (method == "newton")
+        {
+            haa = 2.0 * s.sxx / s.n;
+            hab = 2.0 * s.sx / s.n;
+            hbb = 2.0;
+            det = haa * hbb - hab * hab;
+            da = (hbb * ga - hab * gb) / det;
+            db = (haa * gb - hab * ga) / det;
+        }
+        else
+        {
+            step = 1.0 / hessian_lmax(s);
+            da = step * ga;
+            db = step * gb;
+        }
+        a -= da;
+        b -= db;
+
+        if (method == "sgd")
+        {
+            suma += a;
+            sumb += b;
+            if (iter % SGD_WINDOW == 0)
+            {
+                da = suma / SGD_WINDOW - avga;
+                db = sumb / SGD_WINDOW - avgb;
+                avga = suma / SGD_WINDOW;
+                avgb = sumb / SGD_WINDOW;
+                suma = 0.0;
+                sumb = 0.0;
+                if (iter > SGD_WINDOW && fabs(da) < tol && fabs(db) < tol)
+                {
+                    res.converged = true;
+                    break;
+                }
+            }
+        }
+        else if (fabs(da) < tol && fabs(db) < tol)
+        {
+            res.converged = true;
+            break;
+        }
+    }
+    if (method == "sgd")
+    {
+        // stopping at maxiter can leave a partial window (or only that, when
+        // maxiter < SGD_WINDOW); its iterates still count
+        rest = res.converged ? 0 : maxiter % SGD_WINDOW;
+        if (rest > 0)
+        {
+            full = (maxiter >= SGD_WINDOW) ? SGD_WINDOW : 0;
+            avga = (full * avga + suma) / (full + rest);
+            avgb = (full * avgb + sumb) / (full + rest);
+        }
+        a = avga;
+        b = avgb;
+    }
+    res.a = a;
+    res.b = b;
+    res.iters = std::min(iter, maxiter);
+
+    // the MSE of the answer, over all points
+    mine = local_grad_sums(x, y, len, a, b, nthreads);
+    MPI_Allreduce(&mine.n, &s.n, GRADSUMS_LEN, MPI_DOUBLE, MPI_SUM, comm);
+    res.mse = s.srr / s.n;
+    return res;
+}
+
+#endif
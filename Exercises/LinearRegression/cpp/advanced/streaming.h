@@ -0,0 +1,113 @@
+/***
+ * File: streaming.h
+ * Description: Generate-and-evaluate passes that never store the dataset
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 1:12:40 pm
+ * Last Modified: Saturday, 17th October 2026, 1:12:43 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_STREAMING_H
+#define LINREG_STREAMING_H
+
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+#include "dataset.h"
+#include "rss_kernel.h"
+#include "sufficient_stats.h"
+
+// Streaming counterparts of rss_candidates and local_moments. Each thread
+// owns two buffers of block points; it generates one block of its PE's
+// range into them (x is just i*dx), evaluates it and moves on, so memory
+// use is 2*block doubles per thread no matter how large the dataset is.
+// Partial results are combined in thread order, as in rss_candidates.
+
+inline void stream_rss_candidates(rss_fn kernel, const Dataset &data,
+                                  const double *as, const double *bs, int ncand,
+                                  size_t block, double *rss, int nthreads)
+{
+    std::vector<double> partial((size_t)nthreads * ncand, 0.0);
+    long long ib, nblocks, first, last;
+    int c, t;
+
+    nblocks = (data.size() + block - 1) / block;
+#pragma omp parallel num_threads(nthreads) private(c, first, last)
+    {
+        double *mine = partial.data() + (size_t)omp_get_thread_num() * ncand;
+        std::vector<double> xb(block), yb(block);
+#pragma omp for schedule(static)
+        for (ib = 0; ib < nblocks; ib++)
+        {
+            first = data.start + ib * (long long)block;
+            last = std::min(first + (long long)block, data.stop);
+            generate_slice(first, last, data.dx, data.at, data.bt, data.seed, xb.data(), yb.data(), 1);
+            for (c = 0; c < ncand; c++)
+            {
+                mine[c] += kernel(xb.data(), yb.data(), last - first, as[c], bs[c]);
+            }
+        }
+    }
+
+    for (c = 0; c < ncand; c++)
+    {
+        rss[c] = 0.0;
+        for (t = 0; t < nthreads; t++)
+        {
+            rss[c] += partial[(size_t)t * ncand + c];
+        }
+    }
+}
+
+inline Moments stream_moments(const Dataset &data, size_t block, int nthreads)
+{
+    std::vector<Moments> partial(nthreads);
+    Moments m = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    long long ib, nblocks, first, last;
+    int t;
+
+    nblocks = (data.size() + block - 1) / block;
+#pragma omp parallel num_threads(nthreads) private(first, last)
+    {
+        Moments &mine = partial[omp_get_thread_num()];
+        std::vector<double> xb(block), yb(block);
+        mine = m;
+#pragma omp for schedule(static)
+        for (ib = 0; ib < nblocks; ib++)
+        {
+            first = data.start + ib * (long long)block;
+            last = std::min(first + (long long)block, data.stop);
+            generate_slice(first, last, data.dx, data.at, data.bt, data.seed, xb.data(), yb.data(), 1);
+            add_moments(xb.data(), yb.data(), last - first, mine);
+        }
+    }
+
+    for (t = 0; t < nthreads; t++)
+    {
+        m.n += partial[t].n;
+        m.sx += partial[t].sx;
+        m.sy += partial[t].sy;
+        m.sxx += partial[t].sxx;
+        m.sxy += partial[t].sxy;
+        m.syy += partial[t].syy;
+    }
+    return m;
+}
+
+#endif
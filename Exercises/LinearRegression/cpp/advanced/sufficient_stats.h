@@ -0,0 +1,92 @@
+/***
+ * File: sufficient_stats.h
+ * Description: Sufficient statistics for the squared-error loss of a straight line
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 9:10:40 am
+ * Last Modified: Saturday, 17th October 2026, 9:10:42 am
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_SUFFICIENT_STATS_H
+#define LINREG_SUFFICIENT_STATS_H
+
+#include <vector>
+#include <mpi.h>
+
+// Expanding the residual sum of squares of ys = a*x + b gives
+//     RSS(a,b) = a^2 Sxx + 2ab Sx + n b^2 - 2a Sxy - 2b Sy + Syy
+// so the six numbers below are all we need to score any (a,b) candidate.
+// They are kept in one contiguous block so a single reduction combines them.
+struct Moments
+{
+    double n;   // number of points (a double so the whole struct is one MPI_DOUBLE block)
+    double sx;  // sum of x
+    double sy;  // sum of y
+    double sxx; // sum of x^2
+    double sxy; // sum of x*y
+    double syy; // sum of y^2
+};
+const int MOMENTS_LEN = 6;
+
+// One pass over the local chunk, shared among nthreads OpenMP threads
+inline Moments local_moments(const std::vector<double> &x, const std::vector<double> &y, int nthreads)
+{
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, syy = 0.0;
+    long long k, len = x.size();
+#pragma omp parallel for num_threads(nthreads) schedule(static) reduction(+ : sx, sy, sxx, sxy, syy)
+    for (k = 0; k < len; k++)
+    {
+        sx += x[k];
+        sy += y[k];
+        sxx += x[k] * x[k];
+        sxy += x[k] * y[k];
+        syy += y[k] * y[k];
+    }
+    Moments m = {double(len), sx, sy, sxx, sxy, syy};
+    return m;
+}
+
+// Add the moments of len points to m, serially; used on cache blocks
+inline void add_moments(const double *x, const double *y, size_t len, Moments &m)
+{
+    size_t k;
+    for (k = 0; k < len; k++)
+    {
+        m.sx += x[k];
+        m.sy += y[k];
+        m.sxx += x[k] * x[k];
+        m.sxy += x[k] * y[k];
+        m.syy += y[k] * y[k];
+    }
+    m.n += double(len);
+}
+
+// Combine the moments of all PEs on root
+inline int reduce_moments(const Moments &mine, Moments &world, int root, MPI_Comm comm)
+{
+    return MPI_Reduce(&mine.n, &world.n, MOMENTS_LEN, MPI_DOUBLE, MPI_SUM, root, comm);
+}
+
+// O(1) scoring of one candidate
+inline double moments_rss(const Moments &m, double as, double bs)
+{
+    return as * as * m.sxx + 2.0 * as * bs * m.sx + m.n * bs * bs - 2.0 * as * m.sxy - 2.0 * bs * m.sy + m.syy;
+}
+
+#endif
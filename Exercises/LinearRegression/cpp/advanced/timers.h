@@ -0,0 +1,81 @@
+/***
+ * File: timers.h
+ * Description: Per-phase wall-clock timings, summarized across PEs
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 2:41:07 pm
+ * Last Modified: Saturday, 17th October 2026, 2:41:09 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+#ifndef LINREG_TIMERS_H
+#define LINREG_TIMERS_H
+
+#include <iostream>
+#include <iomanip>
+#include <mpi.h>
+
+// The phases every run goes through. Init covers everything up to the first
+// repetition (MPI start-up, options, layout, process grid); the others are
+// averaged over the --reps repetitions of steps 1-4.
+enum Phase
+{
+    PHASE_INIT,   // MPI_Init_thread, options and communicators
+    PHASE_DATA,   // steps 1 and 2: parameter map, dataset generation or file I/O
+    PHASE_SEARCH, // step 3: every refinement level, including picking each level's best point
+    PHASE_SELECT, // step 4: final selection and printing of the result
+    NPHASES
+};
+
+const char *const PHASE_NAMES[NPHASES] = {"init", "data", "search", "select"};
+
+// Min, average and max of each phase over the PEs of comm, printed on root.
+// t holds this PE's seconds per phase; the total row is the per-PE sum of
+// the phases, reduced the same way. The last column is the load imbalance,
+// max over average (1 is perfect balance). The lines are comma separated so
+// that scripts can pick them up with "grep ^phase".
+inline void report_phases(const double t[NPHASES], int reps, int root, MPI_Comm comm)
+{
+    double mine[NPHASES + 1], tmin[NPHASES + 1], tmax[NPHASES + 1], tsum[NPHASES + 1];
+    int p, myrank, nranks;
+
+    MPI_Comm_rank(comm, &myrank);
+    MPI_Comm_size(comm, &nranks);
+    mine[NPHASES] = 0.0;
+    for (p = 0; p < NPHASES; p++)
+    {
+        mine[p] = t[p];
+        mine[NPHASES] += t[p];
+    }
+    MPI_Reduce(mine, tmin, NPHASES + 1, MPI_DOUBLE, MPI_MIN, root, comm);
+    MPI_Reduce(mine, tmax, NPHASES + 1, MPI_DOUBLE, MPI_MAX, root, comm);
+    MPI_Reduce(mine, tsum, NPHASES + 1, MPI_DOUBLE, MPI_SUM, root, comm);
+    if (myrank == root)
+    {
+        std::cout << "\nPhase timings over " << nranks << " PE(s), average of " << reps << " repetition(s)" << std::endl;
+        std::cout << "phase,min_s,avg_s,max_s,imbalance" << std::endl;
+        for (p = 0; p <= NPHASES; p++)
+        {
+            std::cout << "phase," << (p < NPHASES ? PHASE_NAMES[p] : "total") << std::scientific << std::setprecision(6);
+            std::cout << "," << tmin[p] << "," << tsum[p] / nranks << "," << tmax[p] << std::defaultfloat;
+            std::cout << "," << ((tsum[p] > 0.0) ? tmax[p] * nranks / tsum[p] : 1.0) << std::endl;
+        }
+    }
+}
+
+#endif
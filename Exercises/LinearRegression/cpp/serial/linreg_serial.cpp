@@ -101,7 +101,7 @@ int main()
             for (k = 0; k < n; k++)
             {
                 ys = as * x[k] + bs;
-                rss = rss + pow((ys - y[k]), 2.0);
+                rss = rss + (ys - y[k]) * (ys - y[k]);
             }
             mse.push_back(rss / n);
             cout << "(a,b) = (" << a[i] << "," << b[j] << ")      RSS = " << rss / n << endl;
@@ -151,7 +151,7 @@ int main()
             for (k = 0; k < mychunksize; k++)
             {
                 ys = as * x[k] + bs;
-                rss = rss + pow((ys - y[k]), 2.0);
+                rss = rss + (ys - y[k]) * (ys - y[k]);
             }
 
             // We combine these RSSs with a reduction by sum and send it to the manager
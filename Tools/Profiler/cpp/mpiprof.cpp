@@ -0,0 +1,445 @@
+/***
+ * File: mpiprof.cpp
+ * Description: PMPI interposition library: per-call counts, bytes and time, reported at MPI_Finalize
+ * Author: Bruno R. de Abreu  |  babreu at illinois dot edu
+ * National Center for Supercomputing Applications (NCSA)
+ *
+ * Creation Date: Saturday, 17th October 2026, 4:03:18 pm
+ * Last Modified: Saturday, 17th October 2026, 4:03:21 pm
+ *
+ * Copyright (c) 2022, Bruno R. de Abreu, National Center for Supercomputing Applications.
+ * All rights reserved.
+ * License: This program and the accompanying materials are made available to any individual
+ *          under the citation condition that follows: On the event that the software is
+ *          used to generate data that is used implicitly or explicitly for research
+ *          purposes, proper acknowledgment must be provided in the citations section of
+ *          publications. This includes both the author's name and the National Center
+ *          for Supercomputing Applications. If you are uncertain about how to do
+ *          so, please check this page: https://github.com/babreu-ncsa/cite-me.
+ *          This software cannot be used for commercial purposes in any way whatsoever.
+ *          Omitting this license when redistributing the code is strongly disencouraged.
+ *          The software is provided without warranty of any kind. In no event shall the
+ *          author or copyright holders be liable for any kind of claim in connection to
+ *          the software and its usage.
+ ***/
+
+/****
+ ***    Every MPI function is also available under the name PMPI_...; the
+ ***    functions below take the MPI_... names, count and time the call and
+ ***    forward it to the PMPI_... version. Linking this library before the
+ ***    MPI library (or preloading it) is enough to profile a program, without
+ ***    touching its source code.
+ ****/
+
+#include <mpi.h>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+
+using namespace std;
+
+// The calls we keep track of
+enum Call
+{
+    CALL_SEND,
+    CALL_SSEND,
+    CALL_ISEND,
+    CALL_RECV,
+    CALL_IRECV,
+    CALL_SENDRECV,
+    CALL_WAIT,
+    CALL_WAITALL,
+    CALL_TEST,
+    CALL_SEND_INIT,
+    CALL_RECV_INIT,
+    CALL_START,
+    CALL_STARTALL,
+    CALL_BARRIER,
+    CALL_BCAST,
+    CALL_IBCAST,
+    CALL_REDUCE,
+    CALL_ALLREDUCE,
+    CALL_IREDUCE,
+    CALL_IALLREDUCE,
+    CALL_REDUCE_INIT,
+    CALL_GATHER,
+    CALL_GATHERV,
+    CALL_SCATTER,
+    CALL_SCATTERV,
+    CALL_ALLGATHER,
+    CALL_ALLGATHERV,
+    CALL_ALLTOALL,
+    NCALLS
+};
+
+const char *const CALL_NAMES[NCALLS] = {
+    "MPI_Send", "MPI_Ssend", "MPI_Isend", "MPI_Recv", "MPI_Irecv", "MPI_Sendrecv",
+    "MPI_Wait", "MPI_Waitall", "MPI_Test", "MPI_Send_init", "MPI_Recv_init", "MPI_Start",
+    "MPI_Startall", "MPI_Barrier", "MPI_Bcast", "MPI_Ibcast", "MPI_Reduce", "MPI_Allreduce",
+    "MPI_Ireduce", "MPI_Iallreduce", "MPI_Reduce_init", "MPI_Gather", "MPI_Gatherv",
+    "MPI_Scatter", "MPI_Scatterv", "MPI_Allgather", "MPI_Allgatherv", "MPI_Alltoall"};
+
+// What this PE has done so far. Bytes are those of the buffer this PE passed
+// in (sent, received or contributed to a collective); the non-blocking calls
+// count their bytes when posted and their waiting time in MPI_Wait/MPI_Test.
+// Persistent requests are set up without moving data, so their *_init call
+// counts no bytes; every MPI_Start/MPI_Startall counts the bytes of the
+// requests it starts instead.
+static long long prof_calls[NCALLS];
+static double prof_bytes[NCALLS];
+static double prof_time[NCALLS];
+static double prof_start; // MPI_Init time, for the share of the run spent in MPI
+static map<MPI_Request, long long> prof_persistent; // bytes of each live persistent request
+
+static long long type_bytes(int count, MPI_Datatype type)
+{
+    int size;
+    PMPI_Type_size(type, &size);
+    return (long long)count * size;
+}
+
+static void record(Call c, double t0, long long bytes)
+{
+    prof_time[c] += PMPI_Wtime() - t0;
+    prof_calls[c]++;
+    prof_bytes[c] += double(bytes);
+}
+
+// Start-up: remember when the run started
+
+int MPI_Init(int *argc, char ***argv)
+{
+    int err = PMPI_Init(argc, argv);
+    prof_start = PMPI_Wtime();
+    return err;
+}
+
+int MPI_Init_thread(int *argc, char ***argv, int required, int *provided)
+{
+    int err = PMPI_Init_thread(argc, argv, required, provided);
+    prof_start = PMPI_Wtime();
+    return err;
+}
+
+// Point-to-point
+
+int MPI_Send(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Send(buf, count, datatype, dest, tag, comm);
+    record(CALL_SEND, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Ssend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Ssend(buf, count, datatype, dest, tag, comm);
+    record(CALL_SSEND, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Isend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Isend(buf, count, datatype, dest, tag, comm, request);
+    record(CALL_ISEND, t0, type_bytes(count, datatype));
+    return err;
+}
+
+// The bytes actually received, which may be fewer than count
+int MPI_Recv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status *status)
+{
+    MPI_Status mine;
+    int received;
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Recv(buf, count, datatype, source, tag, comm, (status == MPI_STATUS_IGNORE) ? &mine : status);
+    PMPI_Get_count((status == MPI_STATUS_IGNORE) ? &mine : status, MPI_BYTE, &received);
+    record(CALL_RECV, t0, (received == MPI_UNDEFINED) ? 0 : received);
+    return err;
+}
+
+int MPI_Irecv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Irecv(buf, count, datatype, source, tag, comm, request);
+    record(CALL_IRECV, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Sendrecv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, int dest, int sendtag,
+                 void *recvbuf, int recvcount, MPI_Datatype recvtype, int source, int recvtag,
+                 MPI_Comm comm, MPI_Status *status)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Sendrecv(sendbuf, sendcount, sendtype, dest, sendtag, recvbuf, recvcount, recvtype,
+                            source, recvtag, comm, status);
+    record(CALL_SENDRECV, t0, type_bytes(sendcount, sendtype) + type_bytes(recvcount, recvtype));
+    return err;
+}
+
+int MPI_Wait(MPI_Request *request, MPI_Status *status)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Wait(request, status);
+    record(CALL_WAIT, t0, 0);
+    return err;
+}
+
+int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[])
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Waitall(count, array_of_requests, array_of_statuses);
+    record(CALL_WAITALL, t0, 0);
+    return err;
+}
+
+int MPI_Test(MPI_Request *request, int *flag, MPI_Status *status)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Test(request, flag, status);
+    record(CALL_TEST, t0, 0);
+    return err;
+}
+
+// Persistent point-to-point
+
+int MPI_Send_init(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm,
+                  MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Send_init(buf, count, datatype, dest, tag, comm, request);
+    record(CALL_SEND_INIT, t0, 0);
+    prof_persistent[*request] = type_bytes(count, datatype);
+    return err;
+}
+
+int MPI_Recv_init(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+                  MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Recv_init(buf, count, datatype, source, tag, comm, request);
+    record(CALL_RECV_INIT, t0, 0);
+    prof_persistent[*request] = type_bytes(count, datatype);
+    return err;
+}
+
+// Look the request up before starting it: the handle is all we get
+int MPI_Start(MPI_Request *request)
+{
+    map<MPI_Request, long long>::const_iterator it = prof_persistent.find(*request);
+    long long bytes = (it == prof_persistent.end()) ? 0 : it->second;
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Start(request);
+    record(CALL_START, t0, bytes);
+    return err;
+}
+
+int MPI_Startall(int count, MPI_Request array_of_requests[])
+{
+    map<MPI_Request, long long>::const_iterator it;
+    long long bytes = 0;
+    int r;
+    for (r = 0; r < count; r++)
+    {
+        it = prof_persistent.find(array_of_requests[r]);
+        bytes += (it == prof_persistent.end()) ? 0 : it->second;
+    }
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Startall(count, array_of_requests);
+    record(CALL_STARTALL, t0, bytes);
+    return err;
+}
+
+// Not counted; it only keeps a freed handle from being mistaken for a new request
+int MPI_Request_free(MPI_Request *request)
+{
+    prof_persistent.erase(*request);
+    return PMPI_Request_free(request);
+}
+
+// Collectives
+
+int MPI_Barrier(MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Barrier(comm);
+    record(CALL_BARRIER, t0, 0);
+    return err;
+}
+
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Bcast(buffer, count, datatype, root, comm);
+    record(CALL_BCAST, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Ibcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm, MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Ibcast(buffer, count, datatype, root, comm, request);
+    record(CALL_IBCAST, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+    record(CALL_REDUCE, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+    record(CALL_ALLREDUCE, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Ireduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root,
+                MPI_Comm comm, MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Ireduce(sendbuf, recvbuf, count, datatype, op, root, comm, request);
+    record(CALL_IREDUCE, t0, type_bytes(count, datatype));
+    return err;
+}
+
+int MPI_Iallreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
+                   MPI_Comm comm, MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Iallreduce(sendbuf, recvbuf, count, datatype, op, comm, request);
+    record(CALL_IALLREDUCE, t0, type_bytes(count, datatype));
+    return err;
+}
+
+#if MPI_VERSION >= 4
+// Persistent collectives arrived with MPI-4
+int MPI_Reduce_init(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root,
+                    MPI_Comm comm, MPI_Info info, MPI_Request *request)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Reduce_init(sendbuf, recvbuf, count, datatype, op, root, comm, info, request);
+    record(CALL_REDUCE_INIT, t0, 0);
+    prof_persistent[*request] = type_bytes(count, datatype);
+    return err;
+}
+#endif
+
+int MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+               MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    record(CALL_GATHER, t0, type_bytes(sendcount, sendtype));
+    return err;
+}
+
+int MPI_Gatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                const int displs[], MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Gatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm);
+    record(CALL_GATHERV, t0, type_bytes(sendcount, sendtype));
+    return err;
+}
+
+int MPI_Scatter(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Scatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    record(CALL_SCATTER, t0, type_bytes(recvcount, recvtype));
+    return err;
+}
+
+int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype,
+                 void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Scatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    record(CALL_SCATTERV, t0, type_bytes(recvcount, recvtype));
+    return err;
+}
+
+int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                  MPI_Datatype recvtype, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+    record(CALL_ALLGATHER, t0, type_bytes(sendcount, sendtype));
+    return err;
+}
+
+int MPI_Allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                   const int displs[], MPI_Datatype recvtype, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm);
+    record(CALL_ALLGATHERV, t0, type_bytes(sendcount, sendtype));
+    return err;
+}
+
+int MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                 MPI_Datatype recvtype, MPI_Comm comm)
+{
+    double t0 = PMPI_Wtime();
+    int err = PMPI_Alltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+    record(CALL_ALLTOALL, t0, type_bytes(sendcount, sendtype));
+    return err;
+}
+
+// Shut-down: merge everybody's numbers on PE 0 and print them, most expensive call first
+
+int MPI_Finalize()
+{
+    long long calls[NCALLS];
+    double bytes[NCALLS], tsum[NCALLS], tmin[NCALLS], tmax[NCALLS];
+    double wall, wallsum, mpisum = 0.0;
+    int order[NCALLS];
+    int c, k, myrank, nranks;
+
+    wall = PMPI_Wtime() - prof_start;
+    PMPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    PMPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    PMPI_Reduce(prof_calls, calls, NCALLS, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    PMPI_Reduce(prof_bytes, bytes, NCALLS, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    PMPI_Reduce(prof_time, tsum, NCALLS, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    PMPI_Reduce(prof_time, tmin, NCALLS, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+    PMPI_Reduce(prof_time, tmax, NCALLS, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    PMPI_Reduce(&wall, &wallsum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (myrank == 0)
+    {
+        for (c = 0; c < NCALLS; c++)
+        {
+            order[c] = c;
+            mpisum += tsum[c];
+        }
+        sort(order, order + NCALLS, [&tsum](int x, int y) { return tsum[x] > tsum[y]; });
+
+        printf("\nMPI profile: %d PE(s), %.4g s average wall time, %.1f%% of it in MPI\n",
+               nranks, wallsum / nranks, 100.0 * mpisum / wallsum);
+        printf("%-16s %12s %14s %12s %12s %12s %12s %8s\n", "call", "calls", "bytes", "bytes/call",
+               "avg s/PE", "min s/PE", "max s/PE", "%MPI");
+        for (k = 0; k < NCALLS; k++)
+        {
+            c = order[k];
+            if (calls[c] == 0)
+            {
+                continue;
+            }
+            printf("%-16s %12lld %14.0f %12.1f %12.4e %12.4e %12.4e %8.2f\n", CALL_NAMES[c], calls[c], bytes[c],
+                   bytes[c] / calls[c], tsum[c] / nranks, tmin[c], tmax[c],
+                   (mpisum > 0.0) ? 100.0 * tsum[c] / mpisum : 0.0);
+        }
+        fflush(stdout);
+    }
+    return PMPI_Finalize();
+}